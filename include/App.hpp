@@ -23,17 +23,19 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
+#include <memory>
 #include <SDL.h>
 #include <SDL_video.h>
 #include <SDL_events.h>
-#include <SDL_thread.h>
-#include <SDL_mutex.h>
 #include "EventListener.hpp"
 #include "Settings.hpp"
 #include "video/Surface.hpp"
 #include "Grid.hpp"
+#include "ai/OpeningBook.hpp"
 #include "players/Joystick.hpp"
 #include "players/Player.hpp"
+#include "players/AI.hpp"
+#include "players/AIThread.hpp"
 
 /**
  * @brief Main application class
@@ -44,13 +46,8 @@ public:
     enum EState {STATE_START, STATE_INGAME, STATE_END};    /**< Application states for the state machine */
 
 
-    friend int32_t SDLCALL RunAI(void* pData);
-
-
     static App& GetInstance();
 
-    bool GetStopThreads() const noexcept;
-
 
     App(const App& CappOther) = delete;             /**< Copy constructor */
     App(App&& appOther) = default;                  /**< Move constructor */
@@ -67,9 +64,8 @@ private:
     bool _bRunning;             /**< Marks whether the application should continue running */
     EState _eStateCurrent;      /**< The current state of the application for the state machine */
     Settings _settingsGlobal;   /**< The global settings of the application */
-    SDL_Thread* _pSdlThreadAI;  /**< Background AI thread */
-    SDL_sem* _pSdlSemaphoreAI;  /**< Semaphore for the AI thread */
-    bool _bStopThreads;         /**< Signal threads to stop */
+    AIThread _aiThread;         /**< Background thread the AI players search on */
+    std::shared_ptr<AIThread::MoveRequest> _pMoveRequest;   /**< The last move asked of an AI player, if any */
 
     Surface _surfaceDisplay;        /**< The main display surface */
     Surface _surfaceStart;          /**< Picture for the start screen */
@@ -83,6 +79,7 @@ private:
     Surface _surfaceCursorShadow;   /**< Picture for the shadow of the cursor */
 
     Grid _grid;                             /**< Main playing grid */
+    OpeningBook _openingBook;               /**< First moves of the AI for the grid size, if there is a book */
     std::unordered_map<uint8_t, Joystick*>  _htJoysticks;   /**< The joysticks in use */
     std::vector<Player*> _vectorpPlayers;   /**< The current players in the game */
     uint8_t _uyCurrentPlayer;               /** The index for the current player */
@@ -110,6 +107,21 @@ private:
      */
     void Reset();
 
+    /**
+     * @brief Adds an AI player to the game, halving the size of its table for as long as there is no memory for it
+     *
+     * @return true if the player was added
+     * @return false if there is no memory even for the smallest table
+     */
+    bool AddAIPlayer();
+
+    /**
+     * @brief Asks the AI player whose turn it is for its move, which is played once its user event arrives
+     *
+     * @param ai the current player
+     */
+    void RequestAIMove(AI& ai);
+
     /**
      * @brief Handles events where the mouse enters the application window
      */
@@ -303,7 +315,4 @@ private:
 };
 
 
-inline bool App::GetStopThreads() const noexcept { return _bStopThreads; }
-
-
 #endif
@@ -22,7 +22,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include <cstdint>
-#include <vector>
+#include <array>
+#include <cstring>
 #include <ostream>
 
 
@@ -32,20 +33,46 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 class Grid
 {
 public:
+    template <typename TMask, typename TGeometry> friend class Bitboard;
+
     /**< Types of player markers */
     enum EPlayerMark {EMPTY = 0, PLAYER1, PLAYER2};
 
+    static const uint8_t SCuyMaxWidth = 16;     /**< Maximum number of columns of a grid */
+    static const uint8_t SCuyMaxHeight = 15;    /**< Maximum number of rows of a grid */
+    static const uint8_t SCuyMaxCells = SCuyMaxWidth * SCuyMaxHeight;  /**< Maximum number of cells of a grid */
+
+    /**
+     * @brief Read-only view of a row of the grid, which is only valid while the grid lives and is not moved
+     */
+    class Row
+    {
+    public:
+        /**
+         * @brief Construct a new view of a row
+         *
+         * @param CpuyCells the first cell of the row
+         */
+        explicit Row(const uint8_t* CpuyCells) noexcept;
+
+        EPlayerMark operator [](uint8_t uyColumn) const noexcept;  /**< Bracket operator */
+
+    private:
+        const uint8_t* _puyCells;   /**< The first cell of the row, the rest following it */
+
+    };
+
     /* Getters */
     uint8_t GetWidth() const noexcept;
     uint8_t GetHeight() const noexcept;
     uint8_t GetCellsToWin() const noexcept;
-    const std::vector<std::vector<EPlayerMark> >& GetCells() const noexcept;
+    const std::array<uint8_t, SCuyMaxCells>& GetCells() const noexcept;
     int8_t GetNextCell(uint8_t uyColumn) const noexcept;
 
     explicit Grid(uint8_t uyWidth = 7, uint8_t uyHeight = 6, uint8_t uyCellsToWin = 4);   /**< Default constructor */
     
 
-    const std::vector<EPlayerMark>& operator [](uint8_t uyIndex) const noexcept; /**< Bracket operator */
+    Row operator [](uint8_t uyIndex) const noexcept;  /**< Bracket operator */
 
     /**
      * @brief Makes a move in the grid
@@ -55,6 +82,13 @@ public:
      */
     void MakeMove(const EPlayerMark& CePlayerMark, uint8_t uyPlayColumn);
 
+    /**
+     * @brief Takes back the last move made in a column
+     * 
+     * @param uyPlayColumn the column of the move
+     */
+    void UndoMove(uint8_t uyPlayColumn);
+
     /**
      * @brief Checks if a move would be valid
      * 
@@ -83,8 +117,9 @@ private:
     uint8_t _uyWidth;         /**< Width of the grid */
     uint8_t _uyHeight;        /**< Height of the grid */
     uint8_t _uyCellsToWin;    /**< Number of markers in a row that must be achieved */
-    std::vector<std::vector<EPlayerMark> > _vector2playerMarkCells;   /**< A matrix of markers representing the board */
-    std::vector<int8_t> _ayNextCell;        /**< Indicates the next playable cell in a column */
+    /**< The markers of the board row by row from the top, the cells past the last row being left empty */
+    std::array<uint8_t, SCuyMaxCells> _auyCells;
+    std::array<int8_t, SCuyMaxWidth> _ayNextCell;   /**< Indicates the next playable cell in a column */
     uint8_t _uyEmptyCells;                  /**< Indicates the number of empty cells remaining */
     EPlayerMark _ePlayerMarkWinner;         /**< The marker of the player who won the game, or empty */
 
@@ -98,22 +133,42 @@ private:
      */
     bool IsWinnerMove(const EPlayerMark& CePlayerMark, int8_t yPlayColumn) noexcept;
 
+    /**
+     * @brief Gets the index of a cell in the cells of the grid
+     *
+     * @param uyRow the row of the cell, counting from the top
+     * @param uyColumn the column of the cell
+     * @return uint16_t the index of the cell
+     */
+    uint16_t GetCellIndex(uint8_t uyRow, uint8_t uyColumn) const noexcept;
+
 };
 
 
 inline uint8_t Grid::GetWidth() const noexcept { return _uyWidth; }
 inline uint8_t Grid::GetHeight() const noexcept { return _uyHeight; }
 inline uint8_t Grid::GetCellsToWin() const noexcept { return _uyCellsToWin; }
-inline const std::vector<std::vector<Grid::EPlayerMark> >& Grid::GetCells() const noexcept 
-{ return _vector2playerMarkCells; }
+inline const std::array<uint8_t, Grid::SCuyMaxCells>& Grid::GetCells() const noexcept { return _auyCells; }
 inline int8_t Grid::GetNextCell(uint8_t uyColumn) const noexcept { return _ayNextCell[uyColumn]; }
 
 
-inline const std::vector<Grid::EPlayerMark>& Grid::operator [](uint8_t uyIndex) const noexcept 
-{ return _vector2playerMarkCells[uyIndex]; }
+inline Grid::Row Grid::operator [](uint8_t uyIndex) const noexcept
+{ return Row{_auyCells.data() + GetCellIndex(uyIndex, 0)}; }
+
+inline uint16_t Grid::GetCellIndex(uint8_t uyRow, uint8_t uyColumn) const noexcept
+{ return uyRow * _uyWidth + uyColumn; }
+
+inline Grid::Row::Row(const uint8_t* CpuyCells) noexcept : _puyCells{CpuyCells} {}
+
+inline Grid::EPlayerMark Grid::Row::operator [](uint8_t uyColumn) const noexcept
+{ return static_cast<EPlayerMark>(_puyCells[uyColumn]); }
 
 inline bool operator ==(const Grid& Cgrid1, const Grid& Cgrid2) noexcept
-{ return Cgrid1.GetCells() == Cgrid2.GetCells(); }
+{
+    // Cells past the last row are always empty, so all of them can be compared at once
+    return (Cgrid1.GetWidth() == Cgrid2.GetWidth() && Cgrid1.GetHeight() == Cgrid2.GetHeight() &&
+        std::memcmp(Cgrid1.GetCells().data(), Cgrid2.GetCells().data(), Grid::SCuyMaxCells) == 0);
+}
 
 inline Grid::EPlayerMark Grid::CheckWinner() const noexcept { return _ePlayerMarkWinner; }
 
@@ -31,6 +31,8 @@ class Settings
 {
 public:
     static const char* SCsDefaultPath;   /**< Default path for storing the application's settings */
+    static const uint8_t SCuyMaxAITableSize = 16;    /**< Largest AI table in MiB, which the Wii has room for */
+    static const uint8_t SCuyMaxAIThreads = 8;       /**< Most threads the AI searches with */
 
 
     /* Getters and setters */
@@ -42,6 +44,14 @@ public:
     void SetCellsToWin(uint8_t yCellsToWin) noexcept;
     uint8_t GetAIDifficulty() const noexcept;
     void SetAIDifficulty(uint8_t yAIDifficulty) noexcept;
+    uint8_t GetAITableSize() const noexcept;
+    void SetAITableSize(uint8_t yAITableSize) noexcept;
+    uint8_t GetAIThreads() const noexcept;
+    void SetAIThreads(uint8_t yAIThreads) noexcept;
+    uint32_t GetAIThinkTime() const noexcept;
+    void SetAIThinkTime(uint32_t uiAIThinkTime) noexcept;
+    bool GetAIPonder() const noexcept;
+    void SetAIPonder(bool bAIPonder) noexcept;
     const std::string& GetCustomPath() const noexcept;
     void SetCustomPath(const std::string& CsCustomPath) noexcept;
 
@@ -69,6 +79,10 @@ private:
     uint8_t _yBoardHeight;
     uint8_t _yCellsToWin;
     uint8_t _yAIDifficulty;
+    uint8_t _yAITableSize;  /**< Size of the AI transposition table in MiB */
+    uint8_t _yAIThreads;    /**< Number of threads the AI searches with */
+    uint32_t _uiAIThinkTime;    /**< Milliseconds the AI may search for every move, 0 for no limit */
+    bool _bAIPonder;        /**< Indicates the AI searches on the opponent's time */
     std::string _sCustomPath;
     
 };
@@ -82,6 +96,14 @@ inline uint8_t Settings::GetCellsToWin() const noexcept { return _yCellsToWin; }
 inline void Settings::SetCellsToWin(uint8_t yCellsToWin) noexcept { _yCellsToWin = yCellsToWin; }
 inline uint8_t Settings::GetAIDifficulty() const noexcept { return _yAIDifficulty; }
 inline void Settings::SetAIDifficulty(uint8_t yAIDifficulty) noexcept { _yAIDifficulty = yAIDifficulty; }
+inline uint8_t Settings::GetAITableSize() const noexcept { return _yAITableSize; }
+inline void Settings::SetAITableSize(uint8_t yAITableSize) noexcept { _yAITableSize = yAITableSize; }
+inline uint8_t Settings::GetAIThreads() const noexcept { return _yAIThreads; }
+inline void Settings::SetAIThreads(uint8_t yAIThreads) noexcept { _yAIThreads = yAIThreads; }
+inline uint32_t Settings::GetAIThinkTime() const noexcept { return _uiAIThinkTime; }
+inline void Settings::SetAIThinkTime(uint32_t uiAIThinkTime) noexcept { _uiAIThinkTime = uiAIThinkTime; }
+inline bool Settings::GetAIPonder() const noexcept { return _bAIPonder; }
+inline void Settings::SetAIPonder(bool bAIPonder) noexcept { _bAIPonder = bAIPonder; }
 inline const std::string& Settings::GetCustomPath() const noexcept { return _sCustomPath; }
 inline void Settings::SetCustomPath(const std::string& CsCustomPath) noexcept 
 { _sCustomPath = CsCustomPath; }
@@ -0,0 +1,318 @@
+/*
+Bitboard.hpp --- Packed ConnectX board for the AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BITBOARD_HPP_
+#define _BITBOARD_HPP_
+
+#include <cstdint>
+#include <array>
+#include "Bitmask.hpp"
+#include "Geometry.hpp"
+#include "Zobrist.hpp"
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Board representation used by the AI search. Every player has a bitmask with a bit per cell, laid
+ * out column by column from the bottom, with an extra unused bit on top of every column so that lines never
+ * wrap from one column into the next. Lines are then found with shifts: one bit for vertical lines, a column
+ * for horizontal lines and a column minus or plus one bit for the diagonals. A position and its mirror image
+ * are worth the same, so both share a single key, the lower of their two keys. Copying a bitboard never
+ * allocates. A bitboard built for a size known at compile time can only hold grids of that size
+ *
+ * @tparam TMask the bitmask type, either a native 64-bit word or a wider Bitmask
+ * @tparam TGeometry the size of the board if known at compile time, DynamicGeometry otherwise
+ */
+template <typename TMask, typename TGeometry = DynamicGeometry>
+class Bitboard
+{
+public:
+    /* Getters */
+    uint8_t GetWidth() const noexcept;
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+    int8_t GetNextCell(uint8_t uyColumn) const noexcept;
+    uint64_t GetKey() const noexcept;
+    uint8_t GetEmptyCells() const noexcept;
+
+    /**
+     * @brief Construct a new bitboard from a grid
+     *
+     * @param Cgrid the grid to copy
+     */
+    explicit Bitboard(const Grid& Cgrid);
+
+    explicit operator Grid() const;     /**< Conversion operator to grid */
+
+
+    /**
+     * @brief Gets the content of a cell, using the same coordinates as the grid
+     *
+     * @param uyRow the row of the cell, counting from the top
+     * @param uyColumn the column of the cell
+     * @return Grid::EPlayerMark the mark in the cell
+     */
+    Grid::EPlayerMark GetCell(uint8_t uyRow, uint8_t uyColumn) const noexcept;
+
+    /**
+     * @brief Makes a move in the bitboard
+     *
+     * @param CePlayerMark the mark of the player that makes the move
+     * @param uyPlayColumn the chosen column for the move
+     */
+    void MakeMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyPlayColumn);
+
+    /**
+     * @brief Takes back the last move made in a column
+     *
+     * @param uyPlayColumn the column of the move
+     */
+    void UndoMove(uint8_t uyPlayColumn);
+
+    /**
+     * @brief Checks if a move would be valid
+     *
+     * @param uyPlayColumn the chosen column for the move
+     * @return true if the move is valid
+     * @return false if the move is invalid
+     */
+    bool IsValidMove(uint8_t uyPlayColumn) const noexcept;
+
+    /**
+     * @brief Translates a move between the board and the position its key stands for, which is the board
+     * mirrored left to right when the mirrored key is the lower one. Mirroring twice gives back the same
+     * board, so the same translation takes a move stored under the key back to the board
+     *
+     * @param uyPlayColumn the column of the move, or TranspositionTable::SCuyNoMove
+     * @return uint8_t the column of the move on the other board, or the same value if it is not a column
+     */
+    uint8_t GetCanonicalMove(uint8_t uyPlayColumn) const noexcept;
+
+    /**
+     * @brief Finds the threats of a player, the empty cells that would complete a line of the player
+     *
+     * @param CePlayerMark the mark of the player
+     * @return TMask the cells of the threats, whether they can be played right now or not
+     */
+    TMask GetThreats(const Grid::EPlayerMark& CePlayerMark) const noexcept;
+
+    /**
+     * @brief Finds the cells where the next marker of every column that is not full would land
+     *
+     * @return TMask the cells that can be played right now
+     */
+    TMask GetPlayableCells() const noexcept;
+
+    /**
+     * @brief Checks if the cell where the next marker of a column would land is in a set of cells
+     *
+     * @param Cmask the set of cells
+     * @param uyPlayColumn the column to check
+     * @return true if the column is not full and its next cell is in the set
+     * @return false if the column is full or its next cell is not in the set
+     */
+    bool IsNextCellIn(const TMask& Cmask, uint8_t uyPlayColumn) const noexcept;
+
+    /**
+     * @brief Checks if the bitboard is full
+     *
+     * @return true if the bitboard is full
+     * @return false if the bitboard is not full
+     */
+    bool IsFull() const noexcept;
+
+    /**
+     * @brief Checks if the game has been won
+     *
+     * @return EPlayerMark the mark of the player that won
+     */
+    Grid::EPlayerMark CheckWinner() const noexcept;
+
+
+    /**
+     * @brief Computes the number of bits needed to hold a board
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @return uint16_t the number of bits of the layout
+     */
+    static uint16_t GetBitCount(uint8_t uyWidth, uint8_t uyHeight) noexcept;
+
+private:
+    uint8_t _uyWidth;           /**< Width of the board */
+    uint8_t _uyHeight;          /**< Height of the board */
+    uint8_t _uyCellsToWin;      /**< Number of markers in a row that must be achieved */
+    std::array<TMask, 2> _amaskPlayers; /**< The cells occupied by each player */
+    TMask _maskCells;           /**< Every cell of the board, leaving out the unused bits */
+    std::array<uint8_t, Grid::SCuyMaxWidth> _auyHeights;    /**< The number of markers in every column */
+    uint8_t _uyEmptyCells;                  /**< Indicates the number of empty cells remaining */
+    Grid::EPlayerMark _ePlayerMarkWinner;   /**< The marker of the player who won the game, or empty */
+    const Zobrist* _pZobrist;               /**< The key table for the size of the board */
+    uint64_t _ulKey;                        /**< The Zobrist key of the current position */
+    uint64_t _ulMirroredKey;                /**< The Zobrist key of the position mirrored left to right */
+
+    /**
+     * @brief Gets the index of the bit that represents a cell
+     *
+     * @param uyColumn the column of the cell
+     * @param uyHeight the height of the cell, counting from the bottom
+     * @return uint16_t the index of the bit
+     */
+    uint16_t GetBitIndex(uint8_t uyColumn, uint8_t uyHeight) const noexcept;
+
+    /**
+     * @brief Checks if the cells of a player hold a winning line, given that they did not before the last move.
+     * A native word is checked whole, as a shift of it costs a single instruction, while a wider bitmask only
+     * has the lines through the last move checked
+     *
+     * @param CmaskPlayer the cells of the player that made the last move
+     * @param urBitIndex the bit of the cell of the last move
+     * @return true if the cells hold a winning line
+     * @return false if the cells do not hold a winning line
+     */
+    bool HasWinningLine(const TMask& CmaskPlayer, uint16_t urBitIndex) const noexcept;
+
+    /**
+     * @brief Checks if a bitmask holds enough consecutive cells in a direction to win the game
+     *
+     * @param CmaskPlayer the cells of a player
+     * @param urShift the distance between two consecutive bits in the direction to check
+     * @return true if there is a winning line in the direction
+     * @return false if there is no winning line in the direction
+     */
+    bool HasLine(const TMask& CmaskPlayer, uint16_t urShift) const noexcept;
+
+    /**
+     * @brief Checks if a bitmask holds enough consecutive cells through a cell in a direction to win the game
+     *
+     * @param CmaskPlayer the cells of a player, the cell itself among them
+     * @param urBitIndex the bit of the cell
+     * @param urShift the distance between two consecutive bits in the direction to check
+     * @return true if there is a winning line through the cell in the direction
+     * @return false if there is no winning line through the cell in the direction
+     */
+    bool HasLineThrough(const TMask& CmaskPlayer, uint16_t urBitIndex, uint16_t urShift) const noexcept;
+
+    /**
+     * @brief Finds the cells that would complete a line of a player in a direction, occupied or not
+     *
+     * @param CmaskPlayer the cells of a player
+     * @param urShift the distance between two consecutive bits in the direction to check
+     * @return TMask the cells that complete a line in the direction
+     */
+    TMask GetLineThreats(const TMask& CmaskPlayer, uint16_t urShift) const noexcept;
+
+};
+
+
+/**
+ * @brief Builds the bitboard of a grid and hands it to a function. Grids of the common sizes get a bitboard
+ * built for their size, whose shifts, masks and loop bounds are constants, and any other grid gets the
+ * narrowest bitmask that can hold it
+ *
+ * @tparam TFunction the type of the function, which takes any bitboard and returns the same type for all
+ * @param Cgrid the grid
+ * @param function the function
+ * @return auto what the function returns
+ */
+template <typename TFunction>
+auto WithBitboard(const Grid& Cgrid, TFunction function);
+
+
+template <typename TMask, typename TGeometry>
+inline uint8_t Bitboard<TMask, TGeometry>::GetWidth() const noexcept
+{ return (TGeometry::SCbFixed ? TGeometry::SCuyWidth : _uyWidth); }
+template <typename TMask, typename TGeometry>
+inline uint8_t Bitboard<TMask, TGeometry>::GetHeight() const noexcept
+{ return (TGeometry::SCbFixed ? TGeometry::SCuyHeight : _uyHeight); }
+template <typename TMask, typename TGeometry>
+inline uint8_t Bitboard<TMask, TGeometry>::GetCellsToWin() const noexcept
+{ return (TGeometry::SCbFixed ? TGeometry::SCuyCellsToWin : _uyCellsToWin); }
+template <typename TMask, typename TGeometry>
+inline int8_t Bitboard<TMask, TGeometry>::GetNextCell(uint8_t uyColumn) const noexcept
+{ return GetHeight() - 1 - _auyHeights[uyColumn]; }
+template <typename TMask, typename TGeometry>
+inline uint64_t Bitboard<TMask, TGeometry>::GetKey() const noexcept
+{ return (_ulMirroredKey < _ulKey ? _ulMirroredKey : _ulKey); }
+template <typename TMask, typename TGeometry>
+inline uint8_t Bitboard<TMask, TGeometry>::GetEmptyCells() const noexcept { return _uyEmptyCells; }
+
+template <typename TMask, typename TGeometry>
+inline Grid::EPlayerMark Bitboard<TMask, TGeometry>::GetCell(uint8_t uyRow, uint8_t uyColumn) const noexcept
+{
+    uint16_t urIndex = GetBitIndex(uyColumn, GetHeight() - 1 - uyRow);
+
+    if (TestBit(_amaskPlayers[0], urIndex)) return Grid::EPlayerMark::PLAYER1;
+    else if (TestBit(_amaskPlayers[1], urIndex)) return Grid::EPlayerMark::PLAYER2;
+    else return Grid::EPlayerMark::EMPTY;
+}
+
+template <typename TMask, typename TGeometry>
+inline bool Bitboard<TMask, TGeometry>::IsValidMove(uint8_t uyPlayColumn) const noexcept
+{
+    return (uyPlayColumn < GetWidth() && _auyHeights[uyPlayColumn] < GetHeight() &&
+        _ePlayerMarkWinner == Grid::EPlayerMark::EMPTY);
+}
+
+template <typename TMask, typename TGeometry>
+inline uint8_t Bitboard<TMask, TGeometry>::GetCanonicalMove(uint8_t uyPlayColumn) const noexcept
+{ return (_ulMirroredKey < _ulKey && uyPlayColumn < GetWidth() ? GetWidth() - 1 - uyPlayColumn : uyPlayColumn); }
+
+template <typename TMask, typename TGeometry>
+inline bool Bitboard<TMask, TGeometry>::IsNextCellIn(const TMask& Cmask, uint8_t uyPlayColumn) const noexcept
+{
+    return (_auyHeights[uyPlayColumn] < GetHeight() &&
+        TestBit(Cmask, GetBitIndex(uyPlayColumn, _auyHeights[uyPlayColumn])));
+}
+
+template <typename TMask, typename TGeometry>
+inline bool Bitboard<TMask, TGeometry>::IsFull() const noexcept { return (_uyEmptyCells == 0); }
+template <typename TMask, typename TGeometry>
+inline Grid::EPlayerMark Bitboard<TMask, TGeometry>::CheckWinner() const noexcept { return _ePlayerMarkWinner; }
+
+template <typename TMask, typename TGeometry>
+inline uint16_t Bitboard<TMask, TGeometry>::GetBitCount(uint8_t uyWidth, uint8_t uyHeight) noexcept
+{ return uyWidth * (uyHeight + 1); }
+
+template <typename TMask, typename TGeometry>
+inline uint16_t Bitboard<TMask, TGeometry>::GetBitIndex(uint8_t uyColumn, uint8_t uyHeight) const noexcept
+{ return uyColumn * (GetHeight() + 1) + uyHeight; }
+
+template <typename TFunction>
+inline auto WithBitboard(const Grid& Cgrid, TFunction function)
+{
+    const uint8_t CuyWidth = Cgrid.GetWidth(), CuyHeight = Cgrid.GetHeight(), CuyCellsToWin = Cgrid.GetCellsToWin();
+
+    if (CuyWidth == 7 && CuyHeight == 6 && CuyCellsToWin == 4)
+        return function(Bitboard<uint64_t, Geometry<7, 6, 4> >(Cgrid));
+    else if (CuyWidth == 8 && CuyHeight == 7 && CuyCellsToWin == 4)
+        return function(Bitboard<uint64_t, Geometry<8, 7, 4> >(Cgrid));
+    else if (CuyWidth == 9 && CuyHeight == 7 && CuyCellsToWin == 5)
+        return function(Bitboard<Bitmask<2>, Geometry<9, 7, 5> >(Cgrid));
+    else if (CuyWidth == 10 && CuyHeight == 8 && CuyCellsToWin == 5)
+        return function(Bitboard<Bitmask<2>, Geometry<10, 8, 5> >(Cgrid));
+
+    const uint16_t CurBitCount = Bitboard<uint64_t>::GetBitCount(CuyWidth, CuyHeight);
+    if (CurBitCount <= 64) return function(Bitboard<uint64_t>(Cgrid));
+    else if (CurBitCount <= 128) return function(Bitboard<Bitmask<2> >(Cgrid));
+    else return function(Bitboard<Bitmask<4> >(Cgrid));
+}
+
+
+#endif
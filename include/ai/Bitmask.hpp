@@ -0,0 +1,227 @@
+/*
+Bitmask.hpp --- Fixed-width bitmasks for the AI board representation
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BITMASK_HPP_
+#define _BITMASK_HPP_
+
+#include <cstdint>
+#include <array>
+#include <bit>
+
+
+/**
+ * @brief Bitmask made of several 64-bit words, for boards that do not fit in a single word. Word 0 holds
+ * the least significant bits
+ *
+ * @tparam N the number of 64-bit words
+ */
+template <uint8_t N>
+class Bitmask
+{
+public:
+    /**
+     * @brief Conversion constructor from a single word
+     *
+     * @param ulValue the value of the least significant word
+     */
+    constexpr Bitmask(uint64_t ulValue = 0) noexcept;
+
+    /**
+     * @brief Checks the value of a single bit
+     *
+     * @param urIndex the index of the bit
+     * @return true if the bit is set
+     * @return false if the bit is not set
+     */
+    bool Test(uint16_t urIndex) const noexcept;
+
+    /**
+     * @brief Sets a single bit
+     *
+     * @param urIndex the index of the bit
+     */
+    void Set(uint16_t urIndex) noexcept;
+
+    /**
+     * @brief Clears a single bit
+     *
+     * @param urIndex the index of the bit
+     */
+    void Reset(uint16_t urIndex) noexcept;
+
+    /**
+     * @brief Counts the bits that are set
+     *
+     * @return uint16_t the number of bits set
+     */
+    uint16_t Count() const noexcept;
+
+
+    explicit operator bool() const noexcept;    /**< Conversion operator to bool */
+
+    Bitmask& operator &=(const Bitmask& CbitmaskOther) noexcept;    /**< Bitwise AND assignment operator */
+    Bitmask& operator |=(const Bitmask& CbitmaskOther) noexcept;    /**< Bitwise OR assignment operator */
+    Bitmask& operator ^=(const Bitmask& CbitmaskOther) noexcept;    /**< Bitwise XOR assignment operator */
+    Bitmask& operator <<=(uint16_t urShift) noexcept;               /**< Left shift assignment operator */
+    Bitmask& operator >>=(uint16_t urShift) noexcept;               /**< Right shift assignment operator */
+    Bitmask operator ~() const noexcept;                            /**< Bitwise NOT operator */
+
+    bool operator ==(const Bitmask& CbitmaskOther) const noexcept = default;   /**< Equality operator */
+
+private:
+    std::array<uint64_t, N> _aulWords;  /**< The words of the bitmask */
+
+};
+
+
+template <uint8_t N>
+inline constexpr Bitmask<N>::Bitmask(uint64_t ulValue) noexcept : _aulWords{ulValue} {}
+
+template <uint8_t N>
+inline bool Bitmask<N>::Test(uint16_t urIndex) const noexcept
+{ return (_aulWords[urIndex >> 6] >> (urIndex & 63)) & 1; }
+
+template <uint8_t N>
+inline void Bitmask<N>::Set(uint16_t urIndex) noexcept
+{ _aulWords[urIndex >> 6] |= UINT64_C(1) << (urIndex & 63); }
+
+template <uint8_t N>
+inline void Bitmask<N>::Reset(uint16_t urIndex) noexcept
+{ _aulWords[urIndex >> 6] &= ~(UINT64_C(1) << (urIndex & 63)); }
+
+template <uint8_t N>
+inline uint16_t Bitmask<N>::Count() const noexcept
+{
+    uint16_t urCount = 0;
+    for (uint8_t i = 0; i < N; ++i) urCount += std::popcount(_aulWords[i]);
+    return urCount;
+}
+
+template <uint8_t N>
+inline Bitmask<N>::operator bool() const noexcept
+{
+    for (uint8_t i = 0; i < N; ++i) if (_aulWords[i] != 0) return true;
+    return false;
+}
+
+template <uint8_t N>
+inline Bitmask<N>& Bitmask<N>::operator &=(const Bitmask& CbitmaskOther) noexcept
+{
+    for (uint8_t i = 0; i < N; ++i) _aulWords[i] &= CbitmaskOther._aulWords[i];
+    return *this;
+}
+
+template <uint8_t N>
+inline Bitmask<N>& Bitmask<N>::operator |=(const Bitmask& CbitmaskOther) noexcept
+{
+    for (uint8_t i = 0; i < N; ++i) _aulWords[i] |= CbitmaskOther._aulWords[i];
+    return *this;
+}
+
+template <uint8_t N>
+inline Bitmask<N>& Bitmask<N>::operator ^=(const Bitmask& CbitmaskOther) noexcept
+{
+    for (uint8_t i = 0; i < N; ++i) _aulWords[i] ^= CbitmaskOther._aulWords[i];
+    return *this;
+}
+
+template <uint8_t N>
+inline Bitmask<N>& Bitmask<N>::operator <<=(uint16_t urShift) noexcept
+{
+    const uint8_t CuyWordShift = urShift >> 6;  // Whole words to move
+    const uint8_t CuyBitShift = urShift & 63;   // Remaining bits to move inside a word
+
+    for (int8_t i = N - 1; i >= 0; --i)
+    {
+        uint64_t ulWord = 0;
+        if (i >= CuyWordShift)
+        {
+            ulWord = _aulWords[i - CuyWordShift] << CuyBitShift;
+            if (CuyBitShift != 0 && i > CuyWordShift)
+                ulWord |= _aulWords[i - CuyWordShift - 1] >> (64 - CuyBitShift);
+        }
+        _aulWords[i] = ulWord;
+    }
+
+    return *this;
+}
+
+template <uint8_t N>
+inline Bitmask<N>& Bitmask<N>::operator >>=(uint16_t urShift) noexcept
+{
+    const uint8_t CuyWordShift = urShift >> 6;  // Whole words to move
+    const uint8_t CuyBitShift = urShift & 63;   // Remaining bits to move inside a word
+
+    for (uint8_t i = 0; i < N; ++i)
+    {
+        uint64_t ulWord = 0;
+        if (i + CuyWordShift < N)
+        {
+            ulWord = _aulWords[i + CuyWordShift] >> CuyBitShift;
+            if (CuyBitShift != 0 && i + CuyWordShift + 1 < N)
+                ulWord |= _aulWords[i + CuyWordShift + 1] << (64 - CuyBitShift);
+        }
+        _aulWords[i] = ulWord;
+    }
+
+    return *this;
+}
+
+template <uint8_t N>
+inline Bitmask<N> Bitmask<N>::operator ~() const noexcept
+{
+    Bitmask bitmaskResult = *this;
+    for (uint8_t i = 0; i < N; ++i) bitmaskResult._aulWords[i] = ~bitmaskResult._aulWords[i];
+    return bitmaskResult;
+}
+
+
+/* Binary operator overloads */
+template <uint8_t N>
+inline Bitmask<N> operator &(Bitmask<N> bitmask1, const Bitmask<N>& Cbitmask2) noexcept
+{ return bitmask1 &= Cbitmask2; }
+template <uint8_t N>
+inline Bitmask<N> operator |(Bitmask<N> bitmask1, const Bitmask<N>& Cbitmask2) noexcept
+{ return bitmask1 |= Cbitmask2; }
+template <uint8_t N>
+inline Bitmask<N> operator ^(Bitmask<N> bitmask1, const Bitmask<N>& Cbitmask2) noexcept
+{ return bitmask1 ^= Cbitmask2; }
+template <uint8_t N>
+inline Bitmask<N> operator <<(Bitmask<N> bitmask, uint16_t urShift) noexcept { return bitmask <<= urShift; }
+template <uint8_t N>
+inline Bitmask<N> operator >>(Bitmask<N> bitmask, uint16_t urShift) noexcept { return bitmask >>= urShift; }
+
+
+/* Single bit helpers, so that native words and wide bitmasks can be used interchangeably */
+inline bool TestBit(uint64_t ulMask, uint16_t urIndex) noexcept { return (ulMask >> urIndex) & 1; }
+inline void SetBit(uint64_t& ulMask, uint16_t urIndex) noexcept { ulMask |= UINT64_C(1) << urIndex; }
+inline void ResetBit(uint64_t& ulMask, uint16_t urIndex) noexcept { ulMask &= ~(UINT64_C(1) << urIndex); }
+inline uint16_t CountBits(uint64_t ulMask) noexcept { return std::popcount(ulMask); }
+
+template <uint8_t N>
+inline bool TestBit(const Bitmask<N>& Cbitmask, uint16_t urIndex) noexcept { return Cbitmask.Test(urIndex); }
+template <uint8_t N>
+inline void SetBit(Bitmask<N>& bitmask, uint16_t urIndex) noexcept { bitmask.Set(urIndex); }
+template <uint8_t N>
+inline void ResetBit(Bitmask<N>& bitmask, uint16_t urIndex) noexcept { bitmask.Reset(urIndex); }
+template <uint8_t N>
+inline uint16_t CountBits(const Bitmask<N>& Cbitmask) noexcept { return Cbitmask.Count(); }
+
+
+#endif
@@ -0,0 +1,112 @@
+/*
+EndgameSolver.hpp --- Exact win/draw/loss search for the end of a ConnectX game
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ENDGAMESOLVER_HPP_
+#define _ENDGAMESOLVER_HPP_
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include "Bitboard.hpp"
+#include "TranspositionTable.hpp"
+#include "MoveOrdering.hpp"
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Searches a position to the end of the game, finding only whether it is won, drawn or lost. With so
+ * few possible values most nodes are cut off, so once the grid is nearly full the whole game tree can be
+ * searched in less time than a depth-limited search with the evaluation function
+ */
+class EndgameSolver
+{
+public:
+    static const uint8_t SCuyMaxEmptyCells = 16;    /**< Most empty cells of a position worth solving */
+
+    static const int8_t SCyWin = 1;     /**< Value of a won position */
+    static const int8_t SCyDraw = 0;    /**< Value of a drawn position */
+    static const int8_t SCyLoss = -1;   /**< Value of a lost position */
+    static const int8_t SCyUnknown = 2; /**< Value of a position whose solve was given up */
+
+    uint64_t GetNodeCount() const noexcept;
+
+
+    /**
+     * @brief Construct a new solver
+     *
+     * @param uiTableSize the size of the transposition table of the solver in bytes
+     */
+    explicit EndgameSolver(uint32_t uiTableSize);
+
+
+    /**
+     * @brief Finds the value of a position and a move that achieves it
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board to solve, which is left as it was found
+     * @param CePlayerMark the mark of the player to move
+     * @param uyBestMove the best column found
+     * @param CtimePointDeadline when the solve must be given up, if ever
+     * @param CpbCancelled a flag whoever asked for the solve may raise from any thread to give it up, if any
+     * @return int8_t the value of the position for the player to move, or SCyUnknown if the solve was given up,
+     * in which case the best move means nothing
+     */
+    template <typename TMask, typename TGeometry>
+    int8_t Solve(Bitboard<TMask, TGeometry>& bitboard, const Grid::EPlayerMark& CePlayerMark,
+        uint8_t& uyBestMove, const std::chrono::steady_clock::time_point& CtimePointDeadline =
+        std::chrono::steady_clock::time_point::max(), const std::atomic<bool>* CpbCancelled = nullptr) noexcept;
+
+private:
+    static const uint32_t SCuiStopCheckNodes = 1024;    /**< Nodes searched between looks at the clock and flag */
+
+    TranspositionTable _transpositionTable; /**< Values of solved positions, which never go out of date */
+    MoveOrdering _moveOrdering;             /**< Killer and history tables of the solver */
+    uint64_t _ulNodeCount;                  /**< Nodes visited in the last solve */
+    std::chrono::steady_clock::time_point _timePointDeadline;   /**< When the current solve must be given up */
+    const std::atomic<bool>* _pbCancelled;  /**< Raised by whoever asked for the current solve to end it */
+    bool _bStopped;                         /**< Indicates the current solve was given up */
+
+    /**
+     * @brief Negamax search with alpha-beta pruning to the end of the game. Immediate wins are taken without
+     * searching, a single threat of the opponent is blocked without trying anything else and no marker is
+     * played right under a threat of the opponent
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board being searched, which is left as it was found
+     * @param CePlayerMark the mark of this node's player
+     * @param uyPly the distance of the node from the root
+     * @param yAlpha the lowest value this node's player is already assured of
+     * @param yBeta the highest value the other player allows this node to get
+     * @param uyBestMove the best column found
+     * @return int8_t the value of the current node for this node's player
+     */
+    template <typename TMask, typename TGeometry>
+    int8_t Negamax(Bitboard<TMask, TGeometry>& bitboard, const Grid::EPlayerMark& CePlayerMark, uint8_t uyPly,
+        int8_t yAlpha, int8_t yBeta, uint8_t& uyBestMove) noexcept;
+
+};
+
+
+inline uint64_t EndgameSolver::GetNodeCount() const noexcept { return _ulNodeCount; }
+
+
+#endif
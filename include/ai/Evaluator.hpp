@@ -0,0 +1,184 @@
+/*
+Evaluator.hpp --- Incremental evaluation function for the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _EVALUATOR_HPP_
+#define _EVALUATOR_HPP_
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include "WindowTable.hpp"
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Evaluation function built upon windows, every line of as many cells as needed to win. A window
+ * holding markers of a single player is still open to that player, and it is worth more the more markers it
+ * holds. The markers of every player in every window are counted, and only the windows through a cell are
+ * updated when a marker is placed on it or taken back, so the value of a position is always at hand. A window
+ * one marker short of a line marks its empty cell as a threat of that player, and threats are kept up to date
+ * along with the counts. A threat is worth more on the rows where it tends to decide a full grid: odd rows from
+ * the bottom for the first player and even rows for the second one
+ */
+class Evaluator
+{
+public:
+    /**
+     * @brief Construct an evaluator for an empty grid of no cells
+     */
+    Evaluator() noexcept;
+
+    /**
+     * @brief Construct an evaluator for the position of a grid
+     *
+     * @param Cgrid the grid to evaluate
+     */
+    explicit Evaluator(const Grid& Cgrid);
+
+
+    /**
+     * @brief Gets the value of the position
+     *
+     * @param CePlayerMark the mark of the player the value is meant for
+     * @return int32_t the value of the position for the player
+     */
+    int32_t GetScore(const Grid::EPlayerMark& CePlayerMark) const noexcept;
+
+    /**
+     * @brief Places a marker on a cell
+     *
+     * @param CePlayerMark the mark of the player that places the marker
+     * @param uyColumn the column of the cell
+     * @param uyRow the row of the cell, counting from the top as in the grid
+     */
+    void MakeMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) noexcept;
+
+    /**
+     * @brief Takes back a marker from a cell
+     *
+     * @param CePlayerMark the mark of the player that placed the marker
+     * @param uyColumn the column of the cell
+     * @param uyRow the row of the cell, counting from the top as in the grid
+     */
+    void UndoMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) noexcept;
+
+    /**
+     * @brief Scores every window from its counts, rather than from the value kept up to date, a batch of windows
+     * at a time with vector instructions where the target has them
+     *
+     * @return int32_t the value of the position for the first player
+     */
+    int32_t ScoreWindows() const noexcept;
+
+    /**
+     * @brief Scores every window from its counts one by one, as targets without vector instructions do
+     *
+     * @return int32_t the value of the position for the first player
+     */
+    int32_t ScoreWindowsScalar() const noexcept;
+
+    /**
+     * @brief Checks if a cell would complete a line of a player
+     *
+     * @param CePlayerMark the mark of the player
+     * @param uyColumn the column of the cell
+     * @param uyRow the row of the cell, counting from the top as in the grid
+     * @return true if the cell is empty and completes a line of the player
+     * @return false if the cell is occupied or completes no line of the player
+     */
+    bool IsThreat(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) const noexcept;
+
+private:
+    static const int32_t SCiMaxWindowScore = INT32_C(1) << 20;  /**< Cap that keeps any sum of windows finite */
+    static const int32_t SCiParityScore = 16;   /**< Bonus of a threat on a row of the right parity */
+
+    /**< Value of a window per marker count c, which is c^c up to the cap */
+    static constexpr std::array<int32_t, Grid::SCuyMaxWidth + 1> SCaiWindowScores{0, 1, 4, 27, 256, 3125, 46656,
+        823543, SCiMaxWindowScore, SCiMaxWindowScore, SCiMaxWindowScore, SCiMaxWindowScore, SCiMaxWindowScore,
+        SCiMaxWindowScore, SCiMaxWindowScore, SCiMaxWindowScore, SCiMaxWindowScore};
+
+    const WindowTable* _pWindowTable;   /**< Windows of the grid geometry */
+    std::vector<std::array<uint8_t, 2> > _vectorauyWindowCounts;    /**< Markers per player in every window */
+    std::vector<Grid::EPlayerMark> _vectorePlayerMarks; /**< Mark in every cell */
+    std::vector<uint8_t> _vectoruyThreats;  /**< Lines every cell completes for the first and the second player */
+    int32_t _iScore;                    /**< Value of the windows for the first player */
+    int32_t _iParityScore;              /**< Value of the threats on rows of the right parity for the first player */
+
+    /**
+     * @brief Gets the value of a window for the first player
+     *
+     * @param uyCount1 the markers of the first player in the window
+     * @param uyCount2 the markers of the second player in the window
+     * @return int32_t the value of the window for the first player
+     */
+    int32_t GetWindowScore(uint8_t uyCount1, uint8_t uyCount2) const noexcept;
+
+    /**
+     * @brief Checks if a window is one marker short of a line of a player
+     *
+     * @param uyCount the markers of the player in the window
+     * @param uyOtherCount the markers of the other player in the window
+     * @return true if the only empty cell of the window completes a line of the player
+     * @return false if the window holds more than one empty cell or markers of the other player
+     */
+    bool IsThreatWindow(uint8_t uyCount, uint8_t uyOtherCount) const noexcept;
+
+    /**
+     * @brief Finds the empty cell of a window that is one marker short of a line
+     *
+     * @param urWindow the number of the window
+     * @return uint16_t the number of the empty cell
+     */
+    uint16_t GetEmptyCell(uint16_t urWindow) const noexcept;
+
+    /**
+     * @brief Counts one more line completed by a cell for a player
+     *
+     * @param CePlayerMark the mark of the player
+     * @param urCell the number of the cell
+     */
+    void AddThreat(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) noexcept;
+
+    /**
+     * @brief Counts one line less completed by a cell for a player
+     *
+     * @param CePlayerMark the mark of the player
+     * @param urCell the number of the cell
+     */
+    void RemoveThreat(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) noexcept;
+
+    /**
+     * @brief Gets the parity value of a threat, which is only worth something on the rows that favour its player
+     *
+     * @param CePlayerMark the mark of the player of the threat
+     * @param urCell the number of the cell of the threat
+     * @return int32_t the value of the threat for the first player
+     */
+    int32_t GetParityScore(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) const noexcept;
+
+};
+
+
+inline bool Evaluator::IsThreat(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) const noexcept
+{
+    return (_vectoruyThreats[2 * _pWindowTable->GetCell(uyColumn, uyRow) + CePlayerMark - 1] > 0);
+}
+
+
+#endif
@@ -0,0 +1,48 @@
+/*
+Geometry.hpp --- Board sizes known at compile time for the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GEOMETRY_HPP_
+#define _GEOMETRY_HPP_
+
+#include <cstdint>
+
+
+/**
+ * @brief Size of a board known at compile time. A bitboard built for it turns the shifts, masks and loop bounds
+ * that depend on the size into constants. A size of zero stands for a board whose size is only known at run
+ * time, which is what a bitboard gets by default
+ *
+ * @tparam CuyWidth the width of the board, or 0
+ * @tparam CuyHeight the height of the board, or 0
+ * @tparam CuyCellsToWin the number of markers in a row needed to win, or 0
+ */
+template <uint8_t CuyWidth, uint8_t CuyHeight, uint8_t CuyCellsToWin>
+struct Geometry
+{
+    static constexpr uint8_t SCuyWidth = CuyWidth;              /**< Width of the board, or 0 */
+    static constexpr uint8_t SCuyHeight = CuyHeight;            /**< Height of the board, or 0 */
+    static constexpr uint8_t SCuyCellsToWin = CuyCellsToWin;    /**< Markers in a row needed to win, or 0 */
+    static constexpr bool SCbFixed = (CuyWidth != 0);           /**< Indicates the size is known at compile time */
+};
+
+
+using DynamicGeometry = Geometry<0, 0, 0>;  /**< Size known at run time only */
+
+
+#endif
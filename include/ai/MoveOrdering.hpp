@@ -0,0 +1,95 @@
+/*
+MoveOrdering.hpp --- Move ordering heuristics for the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _MOVEORDERING_HPP_
+#define _MOVEORDERING_HPP_
+
+#include <cstdint>
+#include <array>
+#include "Bitboard.hpp"
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Sorts the moves of a node so that the ones most likely to cause a cutoff are searched first: the
+ * best move stored in the transposition table, then the killer moves of the ply, then the moves with the
+ * highest history score and finally the rest from the centre outwards
+ */
+class MoveOrdering
+{
+public:
+    static const uint8_t SCuyMaxPly = Grid::SCuyMaxCells;   /**< Deepest ply of a game */
+
+
+    /**
+     * @brief Construct a new move ordering with no killers and no history
+     */
+    MoveOrdering() noexcept;
+
+
+    /**
+     * @brief Gets the valid moves of a node, best candidates first
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param Cbitboard the board of the node
+     * @param CePlayerMark the mark of the player to move
+     * @param uyHashMove the best move stored in the transposition table, if any
+     * @param uyPly the distance of the node from the root
+     * @param auyMoves the sorted moves
+     * @return uint8_t the number of valid moves
+     */
+    template <typename TMask, typename TGeometry>
+    uint8_t GetMoves(const Bitboard<TMask, TGeometry>& Cbitboard, const Grid::EPlayerMark& CePlayerMark,
+        uint8_t uyHashMove, uint8_t uyPly, std::array<uint8_t, Grid::SCuyMaxWidth>& auyMoves) const noexcept;
+
+    /**
+     * @brief Rewards a move that caused a cutoff
+     *
+     * @param CePlayerMark the mark of the player that made the move
+     * @param uyColumn the column of the move
+     * @param uyRow the row the marker landed on
+     * @param uyPly the distance of the node from the root
+     * @param uyDepthLeft the remaining depth of the node
+     */
+    void AddCutoff(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow, uint8_t uyPly,
+        uint8_t uyDepthLeft) noexcept;
+
+    /**
+     * @brief Prepares for a new search, forgetting the killers and fading the history
+     */
+    void NewSearch() noexcept;
+
+private:
+    static const uint32_t SCuiHashScore = UINT32_MAX;           /**< Score of the transposition table move */
+    static const uint32_t SCuiKillerScore = UINT32_MAX - 2;     /**< Score of the first killer move */
+    static const uint32_t SCuiMaxHistory = UINT32_C(1) << 30;   /**< History score that triggers a fade */
+
+    std::array<std::array<uint8_t, 2>, SCuyMaxPly> _aauyKillers;    /**< Two latest cutoff columns per ply */
+    std::array<std::array<uint32_t, Grid::SCuyMaxCells>, 2> _aauiHistory; /**< Cutoff score per player and cell */
+
+    /**
+     * @brief Halves every history score
+     */
+    void FadeHistory() noexcept;
+
+};
+
+
+#endif
@@ -0,0 +1,136 @@
+/*
+OpeningBook.hpp --- Precomputed first moves of the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _OPENINGBOOK_HPP_
+#define _OPENINGBOOK_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Bitboard.hpp"
+
+
+/**
+ * @brief Best moves of the first positions of a game for a board geometry, found offline by a deep search.
+ * Positions are identified by their Zobrist key and kept sorted, so a lookup is a binary search. A position
+ * and its mirror image share a key and an entry, with the move stored for the board the key stands for. On
+ * disk the book is a small header followed by a key and a column per position, all of it little-endian
+ */
+class OpeningBook
+{
+public:
+    /* Getters */
+    uint8_t GetWidth() const noexcept;
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+    uint32_t GetSize() const noexcept;
+
+    /**
+     * @brief Construct an empty book for a board geometry
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @param uyCellsToWin the number of markers in a row needed to win
+     */
+    OpeningBook(uint8_t uyWidth = 0, uint8_t uyHeight = 0, uint8_t uyCellsToWin = 0) noexcept;
+
+    /**
+     * @brief Constructs a new book by reading a book file
+     *
+     * @param CsFilePath the path to the book file
+     */
+    explicit OpeningBook(const std::string& CsFilePath);
+
+
+    /**
+     * @brief Gets the name of the book file of a board geometry
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @param uyCellsToWin the number of markers in a row needed to win
+     * @return std::string the file name, with no directory
+     */
+    static std::string GetFileName(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin);
+
+
+    /**
+     * @brief Saves the book on disk
+     *
+     * @param CsFilePath the path where the book is to be stored
+     */
+    void Save(const std::string& CsFilePath) const;
+
+    /**
+     * @brief Stores the best move of a position, replacing the one stored before if any
+     *
+     * @param ulKey the Zobrist key of the position, which it shares with its mirror image
+     * @param uyMove the best column of the position, on the board the key stands for
+     */
+    void AddMove(uint64_t ulKey, uint8_t uyMove);
+
+    /**
+     * @brief Looks up the best move of a position
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param Cbitboard the board of the position
+     * @return uint8_t the best column, or TranspositionTable::SCuyNoMove if the book was made for another board
+     * geometry, does not hold the position or holds a move that is not valid
+     */
+    template <typename TMask, typename TGeometry>
+    uint8_t Probe(const Bitboard<TMask, TGeometry>& Cbitboard) const noexcept;
+
+private:
+    static const char SCacMagic[4];         /**< Signature at the start of a book file */
+    static const uint8_t SCuyVersion = 2;   /**< Version of the book file layout */
+    static const uint8_t SCuyEntrySize = 9; /**< Bytes of every position in a book file, its key and its column */
+
+    /**
+     * @brief A position of the book
+     */
+    struct Entry
+    {
+        uint64_t ulKey;     /**< Zobrist key of the position */
+        uint8_t uyMove;     /**< Best column of the position */
+    };
+
+
+    uint8_t _uyWidth;                   /**< Width of the board */
+    uint8_t _uyHeight;                  /**< Height of the board */
+    uint8_t _uyCellsToWin;              /**< Number of markers in a row that must be achieved */
+    std::vector<Entry> _vectorEntries;  /**< Positions of the book, sorted by key */
+
+    /**
+     * @brief Finds the first entry whose key is not lower than a key
+     *
+     * @param ulKey the key to look for
+     * @return std::vector<Entry>::const_iterator the entry, or the end of the entries
+     */
+    std::vector<Entry>::const_iterator LowerBound(uint64_t ulKey) const noexcept;
+
+};
+
+
+inline uint8_t OpeningBook::GetWidth() const noexcept { return _uyWidth; }
+inline uint8_t OpeningBook::GetHeight() const noexcept { return _uyHeight; }
+inline uint8_t OpeningBook::GetCellsToWin() const noexcept { return _uyCellsToWin; }
+inline uint32_t OpeningBook::GetSize() const noexcept { return _vectorEntries.size(); }
+
+
+#endif
@@ -0,0 +1,166 @@
+/*
+SearchStats.hpp --- Instrumentation of the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SEARCHSTATS_HPP_
+#define _SEARCHSTATS_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <ostream>
+
+
+/**
+ * @brief Counts what a search thread did in every iteration of its last search: nodes, leaf evaluations,
+ * cutoffs and transposition table probes. The counters are only kept when SEARCH_STATS is defined, so that
+ * release builds pay nothing for them; otherwise every call does nothing and no iteration is ever recorded
+ */
+class SearchStats
+{
+public:
+    /**
+     * @brief What the search did in one iteration, aspiration window re-searches included. The root itself
+     * is not counted, only the nodes below it
+     */
+    struct Iteration
+    {
+        uint8_t uyDepth;                /**< Plies the iteration searched */
+        bool bComplete;                 /**< Indicates the iteration ended before the search was stopped */
+        uint64_t ulNodes;               /**< Nodes visited */
+        uint64_t ulEvaluations;         /**< Leaves scored by the evaluation */
+        uint64_t ulCutoffs;             /**< Nodes left as soon as a move turned out too good */
+        uint64_t ulFirstMoveCutoffs;    /**< Cutoffs caused by the first move searched */
+        uint64_t ulTableProbes;         /**< Looks into the transposition table */
+        uint64_t ulTableHits;           /**< Looks that found the position */
+    };
+
+
+    /* Getters */
+    const std::vector<Iteration>& GetIterations() const noexcept;
+
+    /**
+     * @brief Construct new statistics with no iterations
+     */
+    SearchStats();
+
+
+    /**
+     * @brief Forgets the iterations of the last search
+     */
+    void NewSearch() noexcept;
+
+    /**
+     * @brief Starts counting a new iteration
+     *
+     * @param uyDepth the plies the iteration searches
+     */
+    void NewIteration(uint8_t uyDepth) noexcept;
+
+    /**
+     * @brief Marks the current iteration as finished before the search was stopped
+     */
+    void EndIteration() noexcept;
+
+    /**
+     * @brief Counts a node of the current iteration
+     */
+    void AddNode() noexcept;
+
+    /**
+     * @brief Counts a leaf scored by the evaluation in the current iteration
+     */
+    void AddEvaluation() noexcept;
+
+    /**
+     * @brief Counts a cutoff of the current iteration
+     *
+     * @param bFirstMove whether the first move searched caused it
+     */
+    void AddCutoff(bool bFirstMove) noexcept;
+
+    /**
+     * @brief Counts a look into the transposition table in the current iteration
+     *
+     * @param bHit whether the position was found
+     */
+    void AddTableProbe(bool bHit) noexcept;
+
+
+    /**
+     * @brief Gets the effective branching factor of an iteration, that is, how many times more nodes it
+     * visited than the one before
+     *
+     * @param uyIteration the index of the iteration
+     * @return double the branching factor, or 0 for the first iteration or one following an empty one
+     */
+    double GetBranchingFactor(uint8_t uyIteration) const noexcept;
+
+    /**
+     * @brief Prints a line per iteration, narrow enough for the Wii console
+     *
+     * @param ostream the stream to print to
+     */
+    void Print(std::ostream& ostream) const;
+
+private:
+    static const uint16_t SCurMaxIterations = 256;  /**< Iterations of the deepest search */
+
+    std::vector<Iteration> _vectorIterations;   /**< Counters of every iteration of the last search */
+
+};
+
+
+inline const std::vector<SearchStats::Iteration>& SearchStats::GetIterations() const noexcept
+{
+    return _vectorIterations;
+}
+
+inline void SearchStats::AddNode() noexcept
+{
+    #ifdef SEARCH_STATS
+        if (!_vectorIterations.empty()) ++_vectorIterations.back().ulNodes;
+    #endif
+}
+
+inline void SearchStats::AddEvaluation() noexcept
+{
+    #ifdef SEARCH_STATS
+        if (!_vectorIterations.empty()) ++_vectorIterations.back().ulEvaluations;
+    #endif
+}
+
+inline void SearchStats::AddCutoff([[maybe_unused]] bool bFirstMove) noexcept
+{
+    #ifdef SEARCH_STATS
+        if (_vectorIterations.empty()) return;
+        ++_vectorIterations.back().ulCutoffs;
+        if (bFirstMove) ++_vectorIterations.back().ulFirstMoveCutoffs;
+    #endif
+}
+
+inline void SearchStats::AddTableProbe([[maybe_unused]] bool bHit) noexcept
+{
+    #ifdef SEARCH_STATS
+        if (_vectorIterations.empty()) return;
+        ++_vectorIterations.back().ulTableProbes;
+        if (bHit) ++_vectorIterations.back().ulTableHits;
+    #endif
+}
+
+
+#endif
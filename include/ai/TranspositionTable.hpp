@@ -0,0 +1,140 @@
+/*
+TranspositionTable.hpp --- Cache of searched ConnectX positions
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _TRANSPOSITIONTABLE_HPP_
+#define _TRANSPOSITIONTABLE_HPP_
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <memory>
+
+
+/**
+ * @brief Fixed-size hash table of search results indexed by Zobrist key. Entries are grouped in buckets the
+ * size of a cache line, so a probe touches a single line of memory. The table can be shared by several search
+ * threads without locking
+ */
+class TranspositionTable
+{
+public:
+    /**< Relation between a stored score and the real value of the position */
+    enum EBound {NONE = 0, EXACT, LOWER, UPPER};
+
+    static const uint8_t SCuyNoMove = 0xFF; /**< Stored when a node has no best move */
+
+
+    /**
+     * @brief An entry of the table
+     */
+    struct Entry
+    {
+        uint64_t ulKey;         /**< Zobrist key of the position */
+        int32_t iScore;         /**< Score found by the search */
+        uint8_t uyDepth;        /**< Remaining depth the position was searched to */
+        uint8_t uyBound;        /**< Type of bound of the score */
+        uint8_t uyMove;         /**< Best column found, or SCuyNoMove */
+        uint8_t uyGeneration;   /**< Search the entry was stored in */
+    };
+
+
+    /**
+     * @brief Construct a new table
+     *
+     * @param uiSize the maximum size of the table in bytes, rounded down to a power of two buckets
+     */
+    explicit TranspositionTable(uint32_t uiSize);
+
+
+    /**
+     * @brief Looks up a position
+     *
+     * @param ulKey the Zobrist key of the position
+     * @param entry the entry that was found, if any
+     * @return true if the position was found
+     * @return false if the position was not found
+     */
+    bool Probe(uint64_t ulKey, Entry& entry) const noexcept;
+
+    /**
+     * @brief Stores the result of a search, replacing the least valuable entry of the bucket if needed
+     *
+     * @param ulKey the Zobrist key of the position
+     * @param uyDepth the remaining depth the position was searched to
+     * @param CeBound the type of bound of the score
+     * @param iScore the score found by the search
+     * @param uyMove the best column found, or SCuyNoMove
+     */
+    void Store(uint64_t ulKey, uint8_t uyDepth, const EBound& CeBound, int32_t iScore, uint8_t uyMove) noexcept;
+
+    /**
+     * @brief Marks the start of a new search, so that older entries get replaced first
+     */
+    void NewSearch() noexcept;
+
+    /**
+     * @brief Empties the table
+     */
+    void Clear() noexcept;
+
+private:
+    #ifdef __wii__
+        static const uint8_t SCuyBucketEntries = 2;     /**< Entries in a 32-byte cache line of Broadway */
+    #else
+        static const uint8_t SCuyBucketEntries = 4;     /**< Entries in a 64-byte cache line */
+    #endif
+
+    /**
+     * @brief An entry as stored in the table, in 32-bit words that every target can access atomically. The
+     * key is stored XORed with the data, so an entry torn by two threads writing at once no longer matches
+     * its key and is ignored
+     */
+    struct Slot
+    {
+        std::array<std::atomic<uint32_t>, 4> auiWords;  /**< High and low key checks, score and packed info */
+    };
+
+    /**
+     * @brief A group of entries sharing a cache line
+     */
+    struct alignas(SCuyBucketEntries * sizeof(Slot)) Bucket
+    {
+        std::array<Slot, SCuyBucketEntries> aSlots;     /**< The entries of the bucket */
+    };
+
+
+    std::unique_ptr<Bucket[]> _pBuckets;    /**< The buckets of the table */
+    uint64_t _ulIndexMask;                  /**< Mask that turns a key into a bucket index */
+    uint8_t _uyGeneration;                  /**< The current search */
+
+    /**
+     * @brief Reads an entry from the table
+     *
+     * @param Cslot the stored entry
+     * @return Entry the entry, with the key it was stored with
+     */
+    static Entry Load(const Slot& Cslot) noexcept;
+
+};
+
+
+inline void TranspositionTable::NewSearch() noexcept { ++_uyGeneration; }
+
+
+#endif
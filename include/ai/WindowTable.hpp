@@ -0,0 +1,120 @@
+/*
+WindowTable.hpp --- Winning windows of a ConnectX board geometry
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _WINDOWTABLE_HPP_
+#define _WINDOWTABLE_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+
+/**
+ * @brief Every window of a board geometry, a window being any vertical, horizontal or diagonal line of as
+ * many cells as needed to win. The cells of all windows are laid out one window after another, and the
+ * windows through every cell one cell after another, so both can be walked over contiguous memory. Cells are
+ * numbered column by column, counting rows from the top as in the grid
+ */
+class WindowTable
+{
+public:
+    /**
+     * @brief Gets the shared window table for a board geometry, building it on first use
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @param uyCellsToWin the number of markers in a row needed to win
+     * @return const WindowTable& the window table
+     */
+    static const WindowTable& GetInstance(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin);
+
+
+    WindowTable(const WindowTable& CwindowTableOther) = delete;             /**< Copy constructor */
+    WindowTable(WindowTable&& windowTableOther) = default;                  /**< Move constructor */
+    WindowTable& operator =(const WindowTable& CwindowTableOther) = delete; /**< Copy assignment operator */
+    WindowTable& operator =(WindowTable&& windowTableOther) = default;      /**< Move assignment operator */
+
+
+    /* Getters */
+    uint8_t GetHeight() const noexcept;
+    uint8_t GetCellsToWin() const noexcept;
+    uint16_t GetCellCount() const noexcept;
+    uint16_t GetWindowCount() const noexcept;
+
+    /**
+     * @brief Gets the number of a cell
+     *
+     * @param uyColumn the column of the cell
+     * @param uyRow the row of the cell, counting from the top
+     * @return uint16_t the number of the cell
+     */
+    uint16_t GetCell(uint8_t uyColumn, uint8_t uyRow) const noexcept;
+
+    /**
+     * @brief Gets the cells of a window
+     *
+     * @param urWindow the number of the window
+     * @return std::span<const uint16_t> the numbers of its cells, in line order
+     */
+    std::span<const uint16_t> GetWindowCells(uint16_t urWindow) const noexcept;
+
+    /**
+     * @brief Gets the windows through a cell
+     *
+     * @param urCell the number of the cell
+     * @return std::span<const uint16_t> the numbers of the windows
+     */
+    std::span<const uint16_t> GetCellWindows(uint16_t urCell) const noexcept;
+
+private:
+    uint8_t _uyHeight;                              /**< Number of rows of the board */
+    uint8_t _uyCellsToWin;                          /**< Number of cells of every window */
+    std::vector<uint16_t> _vectorurWindowCells;     /**< Cells of every window, one window after another */
+    std::vector<uint16_t> _vectorurCellOffsets;     /**< First window of every cell in the list below */
+    std::vector<uint16_t> _vectorurCellWindows;     /**< Windows through every cell, one cell after another */
+
+    /**
+     * @brief Builds the windows of a board geometry
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @param uyCellsToWin the number of markers in a row needed to win
+     */
+    WindowTable(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin);
+
+};
+
+
+inline uint8_t WindowTable::GetHeight() const noexcept { return _uyHeight; }
+inline uint8_t WindowTable::GetCellsToWin() const noexcept { return _uyCellsToWin; }
+inline uint16_t WindowTable::GetCellCount() const noexcept { return _vectorurCellOffsets.size() - 1; }
+inline uint16_t WindowTable::GetWindowCount() const noexcept
+{ return _vectorurWindowCells.size() / _uyCellsToWin; }
+inline uint16_t WindowTable::GetCell(uint8_t uyColumn, uint8_t uyRow) const noexcept
+{ return uyColumn * _uyHeight + uyRow; }
+inline std::span<const uint16_t> WindowTable::GetWindowCells(uint16_t urWindow) const noexcept
+{ return {_vectorurWindowCells.data() + urWindow * _uyCellsToWin, _uyCellsToWin}; }
+inline std::span<const uint16_t> WindowTable::GetCellWindows(uint16_t urCell) const noexcept
+{
+    return {_vectorurCellWindows.data() + _vectorurCellOffsets[urCell],
+        static_cast<size_t>(_vectorurCellOffsets[urCell + 1] - _vectorurCellOffsets[urCell])};
+}
+
+
+#endif
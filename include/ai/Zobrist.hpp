@@ -0,0 +1,80 @@
+/*
+Zobrist.hpp --- Zobrist keys for identifying ConnectX positions
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ZOBRIST_HPP_
+#define _ZOBRIST_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Table of random keys, one per player and cell, for a given board size. The key of a position is the
+ * XOR of the keys of its occupied cells, so it can be updated with a single XOR on every move and undo. Keys
+ * are generated from a fixed seed, so they are the same on every run
+ */
+class Zobrist
+{
+public:
+    /**
+     * @brief Gets the shared key table for a board size, generating it on first use
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     * @return const Zobrist& the key table
+     */
+    static const Zobrist& GetInstance(uint8_t uyWidth, uint8_t uyHeight);
+
+
+    Zobrist(const Zobrist& CzobristOther) = delete;             /**< Copy constructor */
+    Zobrist(Zobrist&& zobristOther) = default;                  /**< Move constructor */
+    Zobrist& operator =(const Zobrist& CzobristOther) = delete; /**< Copy assignment operator */
+    Zobrist& operator =(Zobrist&& zobristOther) = default;      /**< Move assignment operator */
+
+
+    /**
+     * @brief Gets the key of a player's marker on a cell
+     *
+     * @param CePlayerMark the mark of the player, which must not be empty
+     * @param urBitIndex the index of the cell in the bitboard layout
+     * @return uint64_t the key
+     */
+    uint64_t GetKey(const Grid::EPlayerMark& CePlayerMark, uint16_t urBitIndex) const noexcept;
+
+private:
+    uint16_t _urBitCount;               /**< Number of cells in the bitboard layout */
+    std::vector<uint64_t> _vectorulKeys;    /**< Keys of the first player followed by those of the second */
+
+    /**
+     * @brief Generates the keys for a board size
+     *
+     * @param uyWidth the width of the board
+     * @param uyHeight the height of the board
+     */
+    Zobrist(uint8_t uyWidth, uint8_t uyHeight);
+
+};
+
+
+inline uint64_t Zobrist::GetKey(const Grid::EPlayerMark& CePlayerMark, uint16_t urBitIndex) const noexcept
+{ return _vectorulKeys[(CePlayerMark - 1) * _urBitCount + urBitIndex]; }
+
+
+#endif
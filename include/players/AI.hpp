@@ -22,9 +22,18 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstdint>
 #include <limits>
-#include <queue>
+#include <vector>
+#include <atomic>
+#include <chrono>
 #include "Player.hpp"
 #include "../Grid.hpp"
+#include "../ai/Bitboard.hpp"
+#include "../ai/TranspositionTable.hpp"
+#include "../ai/MoveOrdering.hpp"
+#include "../ai/EndgameSolver.hpp"
+#include "../ai/Evaluator.hpp"
+#include "../ai/OpeningBook.hpp"
+#include "../ai/SearchStats.hpp"
 
 
 /**
@@ -34,67 +43,180 @@ class AI : public Player
 {
 public:
     uint8_t GetSearchLimit() const noexcept;
+    uint64_t GetNodeCount() const noexcept;
+    uint8_t GetDepthReached() const noexcept;
+    uint8_t GetThreadCount() const noexcept;
+    uint32_t GetThinkTime() const noexcept;
+    const SearchStats& GetSearchStats() const noexcept;
 
     /**
      * @brief Construct a new AI player
      * 
      * @param CePlayerMark the mark assigned to this player
      * @param uySearchLimit the depth of levels that the AI will explore
+     * @param uyTableSize the size of the transposition table in MiB
+     * @param uyThreadCount the number of threads that search at the same time
+     * @param uiThinkTime the milliseconds the AI may search for every move, 0 for no limit
+     * @param CpOpeningBook the book of first moves to play without searching, if any, which must outlive the AI
      */
     explicit AI(const Grid::EPlayerMark& CePlayerMark, 
-        uint8_t uySearchLimit = std::numeric_limits<uint8_t>::max());
+        uint8_t uySearchLimit = std::numeric_limits<uint8_t>::max(), uint8_t uyTableSize = 4,
+        uint8_t uyThreadCount = 1, uint32_t uiThinkTime = 0, const OpeningBook* CpOpeningBook = nullptr);
 
     /**
      * @brief Makes the AI choose a play on the board
      * 
      * @param grid the main game board
+     * @param CpbCancelled a flag whoever asked for the move may raise from any thread to give up the search, which
+     * plays the best move found so far, if any
+     * @return uint8_t the column played, or TranspositionTable::SCuyNoMove if the grid is full
      */
-    void ChooseMove(Grid& grid) const noexcept;
+    uint8_t ChooseMove(Grid& grid, const std::atomic<bool>* CpbCancelled = nullptr) noexcept;
+
+    /**
+     * @brief Searches the grid left by the last move of the AI from the point of view of the opponent, until
+     * cancelled through its flag. The search fills the transposition table with the likely replies, so that the
+     * next move of the AI starts from them. Pondering runs on the calling thread alone
+     *
+     * @param Cgrid a copy of the main game board, the opponent being next to move
+     * @param CpbCancelled a flag whoever asked for the search may raise from any thread to stop it, if any
+     */
+    void Ponder(const Grid& Cgrid, const std::atomic<bool>* CpbCancelled = nullptr) noexcept;
 
 private:
+    /**< Value of a position won right now. A win one ply further away is worth one less, and a loss is worth
+     * the opposite of the win, so that the shortest wins and the longest losses are preferred */
+    static const int32_t SCiWinScore = std::numeric_limits<int32_t>::max();
+    static const int32_t SCiMinWinScore = SCiWinScore - 512;    /**< Lowest value of a won position */
+    static const int32_t SCiAspirationWindow = 64;  /**< Half width of the first window of every iteration */
+    static const uint32_t SCuiSolverTableSize = UINT32_C(1) << 20;  /**< Bytes of the endgame solver table */
+    static const uint32_t SCuiClockCheckNodes = 1024;   /**< Nodes searched between looks at the clock */
+
+    /**
+     * @brief State of a search thread that is not shared with the others
+     */
+    struct SearchThread
+    {
+        Evaluator evaluator;        /**< Evaluation of the board of the thread */
+        MoveOrdering moveOrdering;  /**< Killer and history tables of the thread */
+        uint64_t ulNodeCount;       /**< Nodes visited by the thread in the last search */
+        uint8_t uyDepthReached;     /**< Plies of the deepest iteration the thread completed in the last search */
+        SearchStats searchStats;    /**< What the thread did in every iteration of the last search */
+    };
+
+
     uint8_t _uySearchLimit; /**< The levels of depth that the AI will explore */
+    uint32_t _uiThinkTime;  /**< Milliseconds the AI may search for every move, 0 for no limit */
+    std::chrono::steady_clock::time_point _timePointDeadline;   /**< When the current search must stop */
+    TranspositionTable _transpositionTable;         /**< Results of previous searches, shared by all threads */
+    std::vector<SearchThread> _vectorSearchThreads; /**< The main search thread followed by the helpers */
+    std::atomic<bool> _bStopSearch;                 /**< Signals every thread to give up */
+    const std::atomic<bool>* _pbCancelled;          /**< Raised by whoever asked for the current search to end it */
+    EndgameSolver _endgameSolver;                   /**< Exact search for nearly full grids */
+    const OpeningBook* _pOpeningBook;               /**< Best first moves found offline, if any */
 
 
     /**
-     * @brief Alpha-Beta Pruning algorithm
+     * @brief Lazy SMP search for the best move. Helper threads search the same position at the same time,
+     * filling the shared transposition table, while the calling thread finds the move that is played. Moves
+     * in the opening book are played without searching, and nearly full grids are solved exactly instead,
+     * unless they turn out to be lost
      * 
-     * @param Cgrid the main game board
-     * @param CePlayerMark the mark of this node's player
-     * @param uyCurrentDepth the current depth of exploration
-     * @param uyMaxDepth the maximum depth to explore
-     * @param iAlpha alpha value for the AB-Pruning algorithm
-     * @param iBeta beta value for the AB-Pruning algorithm
-     * @param bIsMinNode signals if the current node is a Min node
-     * @return int32_t the value of the current node
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param Cbitboard the main game board
+     * @return uint8_t the best column found
      */
-    int32_t AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, 
-        uint8_t uyCurrentDepth, uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode) const noexcept;
+    template <typename TMask, typename TGeometry>
+    uint8_t SearchBestMove(const Bitboard<TMask, TGeometry>& Cbitboard) noexcept;
 
     /**
-     * @brief Evaluation function
+     * @brief Iterative deepening search for the best move. Every iteration but the first searches a narrow
+     * window around the score of the previous one, which is widened on the side the score falls out of until
+     * it falls inside. The search ends early once the position is found to be won or lost. If the search is
+     * stopped, the best move of the last completed iteration is returned
      * 
-     * @param Cgrid the main game board
-     * @return int32_t a numeric evaluation of the board
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard a copy of the main game board, on which moves are made and undone
+     * @param searchThread the state of the thread running the search
+     * @param CePlayerMark the mark of the player to move on the board
+     * @param uyFirstIteration the first iteration to search, so that helpers can start deeper
+     * @param uySearchLimit the iteration to stop before
+     * @return uint8_t the best column found
+     */
+    template <typename TMask, typename TGeometry>
+    uint8_t IterativeDeepening(Bitboard<TMask, TGeometry> bitboard, SearchThread& searchThread,
+        const Grid::EPlayerMark& CePlayerMark, uint8_t uyFirstIteration, uint8_t uySearchLimit) noexcept;
+
+    /**
+     * @brief Searches every move of the root of the board within a window
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board being searched, which is left as it was found
+     * @param searchThread the state of the thread running the search
+     * @param CePlayerMark the mark of the player to move on the board
+     * @param uyDepthLeft the remaining depth to explore after the root moves
+     * @param iAlpha the lowest value of the window
+     * @param iBeta the highest value of the window
+     * @param uyBestMove the best column of the previous iteration, searched first, which is replaced by a
+     * better one if any is found
+     * @return int32_t the value of the root, which is only a bound if it falls outside the window
      */
-    int32_t Heuristic(const Grid& Cgrid) const noexcept;
+    template <typename TMask, typename TGeometry>
+    int32_t SearchRoot(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+        const Grid::EPlayerMark& CePlayerMark, uint8_t uyDepthLeft, int32_t iAlpha, int32_t iBeta,
+        uint8_t& uyBestMove) noexcept;
 
     /**
-     * @brief Helper function for the heuristic function. Used to build and keep track of free sectors, 
-     * where there is only one type of player marker and where such player still has the chance to win
+     * @brief Negamax search with principal variation search. The first move of a node is searched with the
+     * full window and the rest with a null window, being searched again only if they turn out to be better.
+     * Threats are looked at first: a playable one wins at once, a playable one of the opponent is the only
+     * move to search, and no move is searched that lets the opponent play a threat on top of it
      * 
-     * @param Cgrid the main game board
-     * @param uyRow the row of the next cell to be added to the sector
-     * @param uyColumn the column of the next cell to be added to the sector
-     * @param quPlayerMarks the queue of cells that form the sector
-     * @param ePlayerMarkLast the type of the last  non-empty cell that was found
-     * @param uySamePlayerMarkCount the number of player marks of the same type that have been found in the
-     *  current sector
-     * @param uyEmptyCellCount the number of empty cells that have been found since the last non-empty cell
-     * @return int32_t the heuristic evaluation for the current sector
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board being searched, which is left as it was found
+     * @param searchThread the state of the thread running the search
+     * @param CePlayerMark the mark of this node's player
+     * @param uyPly the distance of the node from the root
+     * @param uyDepthLeft the remaining depth to explore
+     * @param iAlpha the lowest value this node's player is already assured of
+     * @param iBeta the highest value the other player allows this node to get
+     * @return int32_t the value of the current node for this node's player
      */
-    int32_t EvaluateSector(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn, 
-        std::queue<Grid::EPlayerMark>& quPlayerMarks, Grid::EPlayerMark& ePlayerMarkLast,
-        uint8_t& uySamePlayerMarkCount, uint8_t& uyEmptyCellCount) const noexcept;
+    template <typename TMask, typename TGeometry>
+    int32_t PrincipalVariationSearch(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+        const Grid::EPlayerMark& CePlayerMark, uint8_t uyPly, uint8_t uyDepthLeft, int32_t iAlpha,
+        int32_t iBeta) noexcept;
+
+    /**
+     * @brief Makes a move on the board of a search thread, keeping its evaluation up to date
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board of the thread
+     * @param searchThread the state of the thread
+     * @param CePlayerMark the mark of the player that makes the move
+     * @param uyColumn the column of the move
+     */
+    template <typename TMask, typename TGeometry>
+    void MakeMove(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+        const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn) const noexcept;
+
+    /**
+     * @brief Takes back the last move made in a column of the board of a search thread, keeping its
+     * evaluation up to date
+     *
+     * @tparam TMask the bitmask type of the board
+     * @tparam TGeometry the size of the board if known at compile time
+     * @param bitboard the board of the thread
+     * @param searchThread the state of the thread
+     * @param uyColumn the column of the move
+     */
+    template <typename TMask, typename TGeometry>
+    void UndoMove(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread, uint8_t uyColumn) const noexcept;
 
 
     /**
@@ -107,25 +229,52 @@ private:
 
 
     /**
-     * @brief Converts a player mark into a value for the evaluation function
-     * 
-     * @param CePlayerMark the player mark to convert
-     * @return int8_t a numeric representation of the player mark for the evaluation function
+     * @brief Converts the value of a node into the one stored in the transposition table, where wins and
+     * losses count their plies from the node instead of from the root
+     *
+     * @param iScore the value of the node
+     * @param uyPly the distance of the node from the root
+     * @return int32_t the value to store
+     */
+    static int32_t ToTableScore(int32_t iScore, uint8_t uyPly) noexcept;
+
+    /**
+     * @brief Converts a value stored in the transposition table back into the value of a node
+     *
+     * @param iScore the stored value
+     * @param uyPly the distance of the node from the root
+     * @return int32_t the value of the node
      */
-    int8_t PlayerMark2Heuristic(const Grid::EPlayerMark& CePlayerMark) const noexcept;
+    static int32_t FromTableScore(int32_t iScore, uint8_t uyPly) noexcept;
+
 };
 
 
 inline uint8_t AI::GetSearchLimit() const noexcept { return _uySearchLimit; }
+inline uint64_t AI::GetNodeCount() const noexcept
+{
+    uint64_t ulNodeCount = 0;
+    for (const SearchThread& CsearchThread : _vectorSearchThreads) ulNodeCount += CsearchThread.ulNodeCount;
+    return ulNodeCount + _endgameSolver.GetNodeCount();
+}
+inline uint8_t AI::GetDepthReached() const noexcept { return _vectorSearchThreads[0].uyDepthReached; }
+inline uint8_t AI::GetThreadCount() const noexcept { return _vectorSearchThreads.size(); }
+inline uint32_t AI::GetThinkTime() const noexcept { return _uiThinkTime; }
+inline const SearchStats& AI::GetSearchStats() const noexcept { return _vectorSearchThreads[0].searchStats; }
 
+inline int32_t AI::ToTableScore(int32_t iScore, uint8_t uyPly) noexcept
+{
+    if (iScore >= SCiMinWinScore) return iScore + uyPly;
+    else if (iScore <= -SCiMinWinScore) return iScore - uyPly;
+    else return iScore;
+}
 
-/**
- * @brief Callback for running the AI algorithm in a separate thread
- *
- * @param pData unused
- * @return int32_t error code of the thread
- */
-int32_t SDLCALL RunAI(void* pData);
+inline int32_t AI::FromTableScore(int32_t iScore, uint8_t uyPly) noexcept
+{
+    if (iScore >= SCiMinWinScore) return iScore - uyPly;
+    else if (iScore <= -SCiMinWinScore) return iScore + uyPly;
+    else return iScore;
+}
 
 
 #endif
\ No newline at end of file
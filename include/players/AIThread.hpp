@@ -0,0 +1,175 @@
+/*
+AIThread.hpp --- Background thread for the ConnectX AI players
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _AITHREAD_HPP_
+#define _AITHREAD_HPP_
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include "AI.hpp"
+#include "../Grid.hpp"
+
+
+/**
+ * @brief Thread on which the AI players search, so that the main thread never waits for their searches. Moves
+ * are asked for through requests, which are searched one after another, and every move found is posted as a
+ * user event
+ */
+class AIThread
+{
+public:
+    static const int32_t SCiMoveEventCode = 1;  /**< Code of the user events that tell a move has been found */
+
+    /**
+     * @brief A move asked of an AI player, shared by whoever asked for it and the AI thread. Once found, the
+     * move is posted as a user event of code SCiMoveEventCode whose first data pointer holds the id of the
+     * request. The AI may go on pondering afterwards, until the request is cancelled
+     */
+    class MoveRequest
+    {
+    public:
+        /* Getters */
+        uint32_t GetId() const noexcept;
+        uint8_t GetMove() const noexcept;
+        bool IsReady() const noexcept;
+        bool IsCancelled() const noexcept;
+
+        /**
+         * @brief Construct a new move request
+         *
+         * @param uiId the number that tells the request apart from the others
+         * @param ai the player that must move, which must outlive the search of the request
+         * @param Cgrid the main game board, which is copied
+         * @param bPonder whether the AI searches on the opponent's time once the move has been found
+         */
+        MoveRequest(uint32_t uiId, AI& ai, const Grid& Cgrid, bool bPonder);
+
+        /**
+         * @brief Gives up the search of the move, or the pondering that follows it. The AI thread notices it
+         * within a few nodes, and no event is posted for a move that has not been posted yet. It can be called
+         * from any thread
+         */
+        void Cancel() noexcept;
+
+    private:
+        friend class AIThread;
+
+        uint32_t _uiId;                 /**< Number that tells the request apart from the others */
+        AI* _pAI;                       /**< The player that must move */
+        Grid _grid;                     /**< Board to move on, left with the move made */
+        bool _bPonder;                  /**< Search on the opponent's time once the move has been found */
+        uint8_t _uyMove;                /**< The column played, once ready */
+        std::atomic<bool> _bReady;      /**< Indicates the move has been found */
+        std::atomic<bool> _bCancelled;  /**< Indicates the move, or the pondering after it, is no longer wanted */
+
+    };
+
+
+    /**
+     * @brief Construct a new AI thread, which waits for requests
+     */
+    AIThread();
+
+    AIThread(const AIThread& CaiThreadOther) = delete;              /**< Copy constructor */
+    AIThread(AIThread&& aiThreadOther) = delete;                    /**< Move constructor */
+
+    ~AIThread() noexcept;   /**< Destructor */
+
+
+    AIThread& operator =(const AIThread& CaiThreadOther) = delete;  /**< Copy assignment operator */
+    AIThread& operator =(AIThread&& aiThreadOther) = delete;        /**< Move assignment operator */
+
+
+    /**
+     * @brief Asks an AI player for its move, which is searched after the requests made before
+     *
+     * @param ai the player that must move, which must outlive the search of the request
+     * @param Cgrid the main game board, which is copied
+     * @param bPonder whether the AI searches on the opponent's time once the move has been found
+     * @return std::shared_ptr<MoveRequest> the handle of the request, through which it can be cancelled
+     */
+    std::shared_ptr<MoveRequest> RequestMove(AI& ai, const Grid& Cgrid, bool bPonder);
+
+    /**
+     * @brief Cancels every request made so far and waits for the AI thread to be done with them, which takes
+     * no longer than the search of a few nodes. The players of the requests can be deleted afterwards
+     */
+    void CancelAll();
+
+    /**
+     * @brief Cancels every request made so far and waits for the AI thread to end. The destructor does it if
+     * it has not been done before
+     */
+    void Stop() noexcept;
+
+private:
+    /**
+     * @brief Something for the AI thread to do: a request to search, a semaphore to post once the jobs before
+     * are done, or neither to end
+     */
+    struct Job
+    {
+        std::shared_ptr<MoveRequest> pMoveRequest;  /**< The request to search, if any */
+        SDL_sem* pSdlSemaphoreDone;                 /**< The semaphore to post, if any */
+    };
+
+
+    SDL_Thread* _pSdlThread;        /**< The thread the AI players search on */
+    SDL_mutex* _pSdlMutex;          /**< Guards the jobs and the request being searched */
+    SDL_sem* _pSdlSemaphore;        /**< Counts the jobs */
+    std::deque<Job> _dequeJobs;     /**< The jobs left, in the order they were given */
+    std::shared_ptr<MoveRequest> _pMoveRequestRunning;  /**< The request being searched or pondered on, if any */
+    uint32_t _uiNextId;             /**< The id of the next request */
+
+
+    /**
+     * @brief Cancels the request being searched and the ones waiting for it
+     */
+    void CancelRequests() noexcept;
+
+    /**
+     * @brief Hands a job to the AI thread
+     *
+     * @param job the job to do after the ones given before
+     */
+    void PushJob(Job job);
+
+    /**
+     * @brief Callback that runs the jobs of the AI thread until told to end
+     *
+     * @param pData the AI thread
+     * @return int32_t error code of the thread
+     */
+    static int32_t SDLCALL Run(void* pData);
+
+};
+
+
+inline uint32_t AIThread::MoveRequest::GetId() const noexcept { return _uiId; }
+inline uint8_t AIThread::MoveRequest::GetMove() const noexcept { return _uyMove; }
+inline bool AIThread::MoveRequest::IsReady() const noexcept { return _bReady.load(std::memory_order_acquire); }
+inline bool AIThread::MoveRequest::IsCancelled() const noexcept
+{ return _bCancelled.load(std::memory_order_relaxed); }
+
+
+#endif
@@ -19,9 +19,9 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 
 #include <cstdint>
-#include <stdexcept>
 #include <unordered_map>
 #include <utility>
+#include <memory>
 #include <ios>
 #include <filesystem>
 
@@ -32,8 +32,6 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <SDL_joystick.h>
 #include <SDL_keyboard.h>
 #include <SDL_timer.h>
-#include <SDL_thread.h>
-#include <SDL_mutex.h>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
 
@@ -54,7 +52,11 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "../../include/Grid.hpp"
 #include "../../include/players/Joystick.hpp"
 #include "../../include/players/Player.hpp"
+#include "../../include/players/AI.hpp"
+#include "../../include/players/AIThread.hpp"
 #include "../../include/EventManager.hpp"
+#include "../../include/ai/WindowTable.hpp"
+#include "../../include/ai/OpeningBook.hpp"
 
 
 App& App::GetInstance()
@@ -68,18 +70,16 @@ App& App::GetInstance()
  * @brief Default constructor
  */
 App::App() : EventListener{}, _bRunning{true}, _eStateCurrent{EState::STATE_START}, _settingsGlobal{},
-    _pSdlThreadAI{nullptr}, _pSdlSemaphoreAI{nullptr}, _bStopThreads{false},
+    _aiThread{}, _pMoveRequest{nullptr},
     _surfaceDisplay{SDL_GetVideoSurface()}, _surfaceStart{}, _surfaceGrid{}, _surfaceMarker1{},
     _surfaceMarker2{}, _surfaceWinPlayer1{}, _surfaceWinPlayer2{}, _surfaceDraw{}, _surfaceCursor{},
-    _surfaceCursorShadow{}, _grid{}, _htJoysticks{}, _vectorpPlayers{}, _uyCurrentPlayer{0},
+    _surfaceCursorShadow{}, _grid{}, _openingBook{}, _htJoysticks{}, _vectorpPlayers{}, _uyCurrentPlayer{0},
     _bSingleController{true}, _yPlayColumn{0}
 {
     SDL_ShowCursor(SDL_DISABLE);    // Default cursor is rendered directly to video memory
     SDL_JoystickEventState(SDL_ENABLE);
     SDL_EnableKeyRepeat(SDL_DEFAULT_REPEAT_DELAY, SDL_DEFAULT_REPEAT_INTERVAL);
 
-    if ((_pSdlSemaphoreAI = SDL_CreateSemaphore(0)) == nullptr) throw std::runtime_error(SDL_GetError());
-
     #ifdef __wii__
 		// Initialise console
         if (SDL_MUSTLOCK(static_cast<SDL_Surface*>(_surfaceDisplay)))
@@ -120,6 +120,13 @@ App::App() : EventListener{}, _bRunning{true}, _eStateCurrent{EState::STATE_STAR
 
     _grid = Grid(_settingsGlobal.GetBoardWidth(), _settingsGlobal.GetBoardHeight(), // Create grid
         _settingsGlobal.GetCellsToWin());
+    WindowTable::GetInstance(_grid.GetWidth(), _grid.GetHeight(), _grid.GetCellsToWin());  // Ready for the AI
+
+    // The opening book of the grid size lies next to the settings
+    try
+    { _openingBook = OpeningBook(std::filesystem::path(Settings::SCsDefaultPath).replace_filename(
+        OpeningBook::GetFileName(_grid.GetWidth(), _grid.GetHeight(), _grid.GetCellsToWin())).string()); }
+    catch (const std::ios_base::failure& CiosBaseFailure) {}
 
     // Retrieve resources from the filesystem
     try
@@ -180,14 +187,8 @@ App::~App() noexcept
     try { _settingsGlobal.Save(Settings::SCsDefaultPath); }     // Save settings
     catch (const std::ios_base::failure& CiosBaseFailure) {}
 
-    /* Signal threads to stop */
-    _bStopThreads = true;
-
-    while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
-    SDL_WaitThread(_pSdlThreadAI, nullptr);
-
-    SDL_DestroySemaphore(_pSdlSemaphoreAI);
-    _pSdlSemaphoreAI = nullptr;
+    /* Stop the AI thread, giving up the search it may be running */
+    _aiThread.Stop();
 
     /* Delete joysticks */
     for (std::unordered_map<uint8_t, Joystick*>::iterator i = _htJoysticks.begin();
@@ -258,17 +259,9 @@ void App::Reset()
     _eStateCurrent = STATE_START;
     _uyCurrentPlayer = 0;
 
-    /* Terminate threads */
-    _bStopThreads = true;
-
-    while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
-    SDL_WaitThread(_pSdlThreadAI, nullptr);
-    _pSdlThreadAI = nullptr;
-
-    _bStopThreads = false;
-
-    SDL_DestroySemaphore(_pSdlSemaphoreAI);
-    if ((_pSdlSemaphoreAI = SDL_CreateSemaphore(0)) == nullptr) throw std::runtime_error(SDL_GetError());
+    // Give up the search of the AI, or its pondering, rather than wait for it to end
+    _aiThread.CancelAll();
+    _pMoveRequest = nullptr;
 
     // Delete joysticks
     for (std::unordered_map<uint8_t, Joystick*>::iterator i = _htJoysticks.begin();
@@ -0,0 +1,74 @@
+/*
+App_AI.cpp --- App requests to the AI players
+Copyright (C) 2022  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <new>
+#include <typeinfo>
+#include "../../include/App.hpp"
+#include "../../include/players/AI.hpp"
+#include "../../include/players/AIThread.hpp"
+
+
+/**
+ * @brief Adds an AI player to the game, halving the size of its table for as long as there is no memory for it
+ *
+ * @return true if the player was added
+ * @return false if there is no memory even for the smallest table
+ */
+bool App::AddAIPlayer()
+{
+    AI* pAI = nullptr;
+
+    for (uint8_t uyTableSize = _settingsGlobal.GetAITableSize(); pAI == nullptr; uyTableSize >>= 1)
+    {
+        try
+        {
+            pAI = new AI(Grid::EPlayerMark::PLAYER2, _settingsGlobal.GetAIDifficulty(), uyTableSize,
+                _settingsGlobal.GetAIThreads(), _settingsGlobal.GetAIThinkTime(), &_openingBook);
+        }
+        catch (const std::bad_alloc& CbadAlloc) { if (uyTableSize == 0) return false; }
+    }
+
+    try { _vectorpPlayers.push_back(pAI); }
+    catch (const std::bad_alloc& CbadAlloc)
+    {
+        delete pAI;
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Asks the AI player whose turn it is for its move, which is played once its user event arrives
+ *
+ * @param ai the current player
+ */
+void App::RequestAIMove(AI& ai)
+{
+    // The AI goes on from what it found on the opponent's time
+    if (_pMoveRequest != nullptr) _pMoveRequest->Cancel();
+
+    // The AI searches on the opponent's time only if the opponent is not another AI
+    const bool CbPonder = _settingsGlobal.GetAIPonder() &&
+        typeid(*(_vectorpPlayers[(_uyCurrentPlayer + 1) % _vectorpPlayers.size()])) != typeid(AI);
+
+    _pMoveRequest = _aiThread.RequestMove(ai, _grid, CbPonder);
+}
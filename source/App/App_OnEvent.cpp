@@ -26,6 +26,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "../../include/Globals.hpp"
 #include "../../include/players/Player.hpp"
 #include "../../include/players/AI.hpp"
+#include "../../include/players/AIThread.hpp"
 #include "../../include/players/Human.hpp"
 
 
@@ -162,12 +163,8 @@ void App::OnLButtonDown(uint16_t urMouseX, uint16_t urMouseY)
         if (/*urMouseX >= 0 && */urMouseX < (Globals::SCurAppWidth >> 1) &&/* urMouseY >= 0 &&*/
             urMouseY < Globals::SCurAppHeight)   // If the controller is pointing at the left half of the screen
         {
-            _eStateCurrent = EState::STATE_INGAME; // Start the game
-
-            // Create an AI player
-            _vectorpPlayers.push_back(new AI(Grid::EPlayerMark::PLAYER2,
-                _settingsGlobal.GetAIDifficulty()));
-            _pSdlThreadAI = SDL_CreateThread(RunAI, nullptr);
+            // Create an AI player and start the game, or stay here if there is no memory for it
+            if (AddAIPlayer()) _eStateCurrent = EState::STATE_INGAME;
         }
         else if (urMouseX >= (Globals::SCurAppWidth >> 1) && urMouseX < Globals::SCurAppWidth &&
             /*urMouseY >= 0 && */urMouseY < Globals::SCurAppHeight) // If the controller is pointing at the right half of the screen
@@ -186,8 +183,11 @@ void App::OnLButtonDown(uint16_t urMouseX, uint16_t urMouseY)
             // If the game is won or there is a draw go to the corresponding state
             if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
                 _eStateCurrent = EState::STATE_END;
-            else if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
-                while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
+            else if (AI* pAI = dynamic_cast<AI*>(_vectorpPlayers[_uyCurrentPlayer]))
+            {
+                try { RequestAIMove(*pAI); }
+                catch (...) { _eStateCurrent = EState::STATE_END; }   // The game cannot go on without the AI
+            }
         }
         break;
     }
@@ -290,12 +290,8 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton) noexcept
             if (iMouseX >= 0 && iMouseX < (Globals::SCurAppWidth >> 1) && iMouseY >= 0 &&
                 iMouseY < Globals::SCurAppHeight)   // If the controller is pointing at the left half of the screen
             {
-                _eStateCurrent = EState::STATE_INGAME; // Start the game
-
-                // Create an AI player
-                _vectorpPlayers.push_back(new AI(Grid::EPlayerMark::PLAYER2,
-                    _settingsGlobal.GetAIDifficulty()));
-                _pSdlThreadAI = SDL_CreateThread(RunAI, nullptr);
+                // Create an AI player and start the game, or stay here if there is no memory for it
+                if (AddAIPlayer()) _eStateCurrent = EState::STATE_INGAME;
             }
             else if (iMouseX >= (Globals::SCurAppWidth >> 1) && iMouseX < Globals::SCurAppWidth &&
                 iMouseY >= 0 && iMouseY < Globals::SCurAppHeight) // If the controller is pointing at the right half of the screen
@@ -341,8 +337,11 @@ void App::OnJoyButtonDown(uint8_t uyWhich, uint8_t uyButton) noexcept
                         // If the game is won or there is a draw go to the corresponding state
                         if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
                             _eStateCurrent = EState::STATE_END;
-                        else if (typeid(*(_vectorpPlayers[_uyCurrentPlayer])) == typeid(AI))
-                            while (SDL_SemPost(_pSdlSemaphoreAI) == -1);
+                        else if (AI* pAI = dynamic_cast<AI*>(_vectorpPlayers[_uyCurrentPlayer]))
+                        {
+                            try { RequestAIMove(*pAI); }
+                            catch (...) { _eStateCurrent = EState::STATE_END; } // The game cannot go on without the AI
+                        }
                     }
                 }
             }
@@ -453,4 +452,28 @@ void App::OnExpose() {}
  * @param pData1 a user-defined data pointer
  * @param pData2 a user-defined data pointer
  */
-void App::OnUser(uint8_t uyType, int32_t iCode, void* pData1, void* pData2) noexcept {}
+void App::OnUser(uint8_t uyType, int32_t iCode, void* pData1, void* pData2) noexcept
+{
+    // Moves of a request since cancelled, or of a game since reset, arrive too late to be played
+    if (uyType != SDL_USEREVENT || iCode != AIThread::SCiMoveEventCode || _pMoveRequest == nullptr ||
+        reinterpret_cast<uintptr_t>(pData1) != _pMoveRequest->GetId() || _eStateCurrent != EState::STATE_INGAME)
+        return;
+
+    if (_grid.IsValidMove(_pMoveRequest->GetMove()))
+        _grid.MakeMove(_vectorpPlayers[_uyCurrentPlayer]->GetPlayerMark(), _pMoveRequest->GetMove());
+
+    // If the game is won or there is a draw go to the corresponding state
+    if (_grid.CheckWinner() != Grid::EPlayerMark::EMPTY || _grid.IsFull())
+        _eStateCurrent = EState::STATE_END;
+    else
+    {
+        ++_uyCurrentPlayer %= _vectorpPlayers.size(); // Move turn
+
+        // Check if next player is another AI, which is asked for its move straight away
+        if (AI* pAI = dynamic_cast<AI*>(_vectorpPlayers[_uyCurrentPlayer]))
+        {
+            try { RequestAIMove(*pAI); }
+            catch (...) { _eStateCurrent = EState::STATE_END; }   // The game cannot go on without the AI
+        }
+    }
+}
@@ -17,7 +17,7 @@ You should have received a copy of the GNU Affero General Public License
 along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <vector>
+#include <array>
 #include <stdexcept>
 #include <ostream>
 #include <cstdint>
@@ -29,15 +29,16 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
  * @brief Construct a new empty Grid
  */
 Grid::Grid(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin) : _uyWidth{uyWidth},
-    _uyHeight{uyHeight}, _uyCellsToWin{uyCellsToWin}, 
-    _vector2playerMarkCells{std::vector<std::vector<EPlayerMark> >(_uyHeight, 
-    std::vector<EPlayerMark>(_uyWidth, EMPTY))}, 
-    _ayNextCell{std::vector<int8_t>(_uyWidth, _uyHeight - 1)}, 
+    _uyHeight{uyHeight}, _uyCellsToWin{uyCellsToWin}, _auyCells{}, _ayNextCell{},
     _uyEmptyCells{static_cast<uint8_t>(_uyWidth * _uyHeight)}, 
     _ePlayerMarkWinner{EPlayerMark::EMPTY}
 { 
+    if (_uyWidth == 0 || _uyWidth > SCuyMaxWidth || _uyHeight == 0 || _uyHeight > SCuyMaxHeight)
+        throw std::length_error("Grid size is out of bounds");
     if (_uyCellsToWin > _uyWidth && _uyCellsToWin > _uyHeight) 
         throw std::length_error("Number of cells to win is too big"); 
+
+    _ayNextCell.fill(_uyHeight - 1);
 }
 
 
@@ -51,7 +52,7 @@ void Grid::MakeMove(const EPlayerMark& CePlayerMark, uint8_t uyPlayColumn)
 {
     if (!IsValidMove(uyPlayColumn)) throw std::domain_error("Play is not valid");
 
-    _vector2playerMarkCells[_ayNextCell[uyPlayColumn]][uyPlayColumn] = CePlayerMark;
+    _auyCells[GetCellIndex(_ayNextCell[uyPlayColumn], uyPlayColumn)] = CePlayerMark;
     --_ayNextCell[uyPlayColumn];
     --_uyEmptyCells;
 
@@ -59,6 +60,25 @@ void Grid::MakeMove(const EPlayerMark& CePlayerMark, uint8_t uyPlayColumn)
 }
 
 
+/**
+ * @brief Takes back the last move made in a column
+ *
+ * @param uyPlayColumn the column of the move
+ */
+void Grid::UndoMove(uint8_t uyPlayColumn)
+{
+    if (uyPlayColumn >= _uyWidth || _ayNextCell[uyPlayColumn] >= _uyHeight - 1)
+        throw std::domain_error("Undo is not valid");
+
+    ++_ayNextCell[uyPlayColumn];
+    ++_uyEmptyCells;
+    _auyCells[GetCellIndex(_ayNextCell[uyPlayColumn], uyPlayColumn)] = EPlayerMark::EMPTY;
+
+    // No move can follow a winning one, so the game is undecided again
+    _ePlayerMarkWinner = EPlayerMark::EMPTY;
+}
+
+
 /**
  * @brief Checks if a play would be valid
  *
@@ -84,15 +104,16 @@ bool Grid::IsValidMove(uint8_t uyPlayColumn) const noexcept
 bool Grid::IsWinnerMove(const EPlayerMark& CePlayerMark, int8_t yPlayColumn) noexcept
 {
     int8_t yPlayRow = _ayNextCell[yPlayColumn] + 1; // The previous row is where the previous play was made
+    const uint8_t* CpuyPlayCell = _auyCells.data() + GetCellIndex(yPlayRow, yPlayColumn);
 
     // Downwards check
     uint8_t uyCounter = 1;
     if (yPlayRow <= _uyHeight - _uyCellsToWin)
     {
         for (uint8_t i = 1; i < _uyCellsToWin && yPlayRow + i < _uyHeight &&
-            _vector2playerMarkCells[yPlayRow + i][yPlayColumn] == CePlayerMark; ++i) ++uyCounter;
+            CpuyPlayCell[i * _uyWidth] == CePlayerMark; ++i) ++uyCounter;
 
-        if (uyCounter == _uyCellsToWin) return true;
+        if (uyCounter >= _uyCellsToWin) return true;
     }
 
     // Check the remaining directions except upwards
@@ -102,25 +123,24 @@ bool Grid::IsWinnerMove(const EPlayerMark& CePlayerMark, int8_t yPlayColumn) noe
     {
         int8_t yDirectionX = CayDirection[0];
         int8_t yDirectionY = CayDirection[1];
+        const int16_t CrStep = yDirectionX * _uyWidth + yDirectionY;   // Distance between cells of the line
 
         // Check one way
         uyCounter = 1;
         for (int8_t i = 1; i < _uyCellsToWin &&
             yPlayRow + i * yDirectionX >= 0 && yPlayRow + i * yDirectionX < _uyHeight &&
             yPlayColumn + i * yDirectionY >= 0 && yPlayColumn + i * yDirectionY < _uyWidth &&
-            _vector2playerMarkCells[yPlayRow + i * yDirectionX][yPlayColumn + i * yDirectionY] == 
-            CePlayerMark; ++i) ++uyCounter;
+            CpuyPlayCell[i * CrStep] == CePlayerMark; ++i) ++uyCounter;
 
-        if (uyCounter == _uyCellsToWin) return true;
+        if (uyCounter >= _uyCellsToWin) return true;
 
         // Check the opposite way
         for (int8_t i = 1; i < _uyCellsToWin &&
             yPlayRow - i * yDirectionX >= 0 && yPlayRow - i * yDirectionX < _uyHeight &&
             yPlayColumn - i * yDirectionY >= 0 && yPlayColumn - i * yDirectionY < _uyWidth &&
-            _vector2playerMarkCells[yPlayRow - i * yDirectionX][yPlayColumn - i * yDirectionY] == 
-            CePlayerMark; ++i) ++uyCounter;
+            CpuyPlayCell[-i * CrStep] == CePlayerMark; ++i) ++uyCounter;
 
-        if (uyCounter == _uyCellsToWin) return true;
+        if (uyCounter >= _uyCellsToWin) return true;
     }
 
     return false;
@@ -147,7 +167,6 @@ std::ostream& operator <<(std::ostream& ostream, const Grid::EPlayerMark& CePlay
  */
 std::ostream& operator <<(std::ostream& ostream, const Grid& Cgrid) noexcept
 {
-    const std::vector<std::vector<Grid::EPlayerMark> > a2playerMarkCells = Cgrid.GetCells();
     std::string sSeparator{};
 
     for (uint8_t i = 0; i < Cgrid.GetWidth() - 1; ++i) sSeparator.append("---+");
@@ -156,10 +175,10 @@ std::ostream& operator <<(std::ostream& ostream, const Grid& Cgrid) noexcept
     for (uint8_t i = 0; i < Cgrid.GetHeight(); ++i)
     {
         ostream << sSeparator << std::endl <<
-            " " << a2playerMarkCells[i][0] << " ";
+            " " << Cgrid[i][0] << " ";
 
         for (uint8_t j = 1; j < Cgrid.GetWidth(); ++j)
-            ostream << "| " << a2playerMarkCells[i][j] << " ";
+            ostream << "| " << Cgrid[i][j] << " ";
 
         ostream << std::endl;
     }
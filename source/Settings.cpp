@@ -23,6 +23,7 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <jansson.h>
 #include "../include/Settings.hpp"
+#include "../include/Grid.hpp"
 
 
 /** Default path for storing the application's settings */
@@ -33,7 +34,8 @@ const char* Settings::SCsDefaultPath = "apps/ConnectXWii/settings.json";
  * @brief Creates an object with the default settings
  */
 Settings::Settings() noexcept : _yBoardWidth{7}, _yBoardHeight{6}, _yCellsToWin{4},
-	_yAIDifficulty{4}, _sCustomPath{"/apps/ConnectXWii/gfx/custom"} {}
+	_yAIDifficulty{4}, _yAITableSize{4}, _yAIThreads{1}, _uiAIThinkTime{5000}, _bAIPonder{true},
+	_sCustomPath{"/apps/ConnectXWii/gfx/custom"} {}
 
 
 /**
@@ -42,7 +44,8 @@ Settings::Settings() noexcept : _yBoardWidth{7}, _yBoardHeight{6}, _yCellsToWin{
  * @param CsFilePath the path to the JSON file holding the settings
  */
 Settings::Settings(const std::string& CsFilePath) : _yBoardWidth{7}, _yBoardHeight{6}, _yCellsToWin{4},
-	_yAIDifficulty{4}, _sCustomPath{"/apps/ConnectXWii/gfx/custom"}
+	_yAIDifficulty{4}, _yAITableSize{4}, _yAIThreads{1}, _uiAIThinkTime{5000}, _bAIPonder{true},
+	_sCustomPath{"/apps/ConnectXWii/gfx/custom"}
 {
     json_t* jsonRoot = nullptr;			// Root object of the JSON file
     json_error_t jsonError{};			// Error handler
@@ -75,10 +78,26 @@ Settings::Settings(const std::string& CsFilePath) : _yBoardWidth{7}, _yBoardHeig
 	if(json_is_integer(jsonField)) _yCellsToWin = json_integer_value(jsonField);
     jsonField = json_object_get(jsonSettings, "AI Difficulty");
 	if(json_is_integer(jsonField)) _yAIDifficulty = json_integer_value(jsonField);
+    jsonField = json_object_get(jsonSettings, "AI table size (MiB)");
+	if(json_is_integer(jsonField)) _yAITableSize = json_integer_value(jsonField);
+    jsonField = json_object_get(jsonSettings, "AI threads");
+	if(json_is_integer(jsonField)) _yAIThreads = json_integer_value(jsonField);
+    jsonField = json_object_get(jsonSettings, "AI think time (ms)");
+	if(json_is_integer(jsonField)) _uiAIThinkTime = json_integer_value(jsonField);
+    jsonField = json_object_get(jsonSettings, "AI ponder");
+	if(json_is_boolean(jsonField)) _bAIPonder = json_boolean_value(jsonField);
 	jsonField = json_object_get(jsonSettings, "Custom path for sprites");
 	if(json_is_string(jsonField)) _sCustomPath = json_string_value(jsonField);
 
 	/* Validation */
+	if (_yBoardWidth == 0) _yBoardWidth = 1;
+	else if (_yBoardWidth > Grid::SCuyMaxWidth) _yBoardWidth = Grid::SCuyMaxWidth;
+	if (_yBoardHeight == 0) _yBoardHeight = 1;
+	else if (_yBoardHeight > Grid::SCuyMaxHeight) _yBoardHeight = Grid::SCuyMaxHeight;
+	if (_yCellsToWin == 0) _yCellsToWin = 1;
+	if (_yAITableSize > SCuyMaxAITableSize) _yAITableSize = SCuyMaxAITableSize;
+	if (_yAIThreads == 0) _yAIThreads = 1;
+	else if (_yAIThreads > SCuyMaxAIThreads) _yAIThreads = SCuyMaxAIThreads;
 	if (_yCellsToWin > _yBoardWidth && _yCellsToWin > _yBoardHeight)
 		_yCellsToWin = std::max(_yBoardWidth, _yBoardHeight);
 
@@ -102,6 +121,10 @@ void Settings::Save(const std::string& CsPath) const
     json_object_set_new(jsonSettings, "Board height", json_integer(_yBoardHeight));
     json_object_set_new(jsonSettings, "Number of cells to win", json_integer(_yCellsToWin));
     json_object_set_new(jsonSettings, "AI Difficulty", json_integer(_yAIDifficulty));
+    json_object_set_new(jsonSettings, "AI table size (MiB)", json_integer(_yAITableSize));
+    json_object_set_new(jsonSettings, "AI threads", json_integer(_yAIThreads));
+    json_object_set_new(jsonSettings, "AI think time (ms)", json_integer(_uiAIThinkTime));
+    json_object_set_new(jsonSettings, "AI ponder", json_boolean(_bAIPonder));
 	json_object_set_new(jsonSettings, "Custom path for sprites", json_string(_sCustomPath.c_str()));
 
 	// Attach the settings to the root
@@ -0,0 +1,302 @@
+/*
+Bitboard.cpp --- Packed ConnectX board for the AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+#include "../../include/ai/Bitboard.hpp"
+#include "../../include/ai/Bitmask.hpp"
+#include "../../include/ai/Geometry.hpp"
+#include "../../include/ai/Zobrist.hpp"
+#include "../../include/Grid.hpp"
+
+
+/**
+ * @brief Construct a new bitboard from a grid
+ *
+ * @param Cgrid the grid to copy
+ */
+template <typename TMask, typename TGeometry>
+Bitboard<TMask, TGeometry>::Bitboard(const Grid& Cgrid) : _uyWidth{Cgrid.GetWidth()},
+    _uyHeight{Cgrid.GetHeight()}, _uyCellsToWin{Cgrid.GetCellsToWin()}, _amaskPlayers{}, _maskCells{}, _auyHeights{},
+    _uyEmptyCells{static_cast<uint8_t>(_uyWidth * _uyHeight)}, _ePlayerMarkWinner{Cgrid.CheckWinner()},
+    _pZobrist{&Zobrist::GetInstance(_uyWidth, _uyHeight)}, _ulKey{0}, _ulMirroredKey{0}
+{
+    if (TGeometry::SCbFixed && (_uyWidth != TGeometry::SCuyWidth || _uyHeight != TGeometry::SCuyHeight ||
+        _uyCellsToWin != TGeometry::SCuyCellsToWin)) throw std::invalid_argument("Grid is not of the board size");
+    if (GetBitCount(GetWidth(), GetHeight()) > sizeof(TMask) * 8)
+        throw std::length_error("Grid is too big for the bitmask");
+
+    for (uint8_t i = 0; i < GetWidth(); ++i)
+    {
+        _auyHeights[i] = GetHeight() - 1 - Cgrid.GetNextCell(i);
+        _uyEmptyCells -= _auyHeights[i];
+
+        for (uint8_t j = 0; j < GetHeight(); ++j) SetBit(_maskCells, GetBitIndex(i, j));
+
+        for (uint8_t j = 0; j < _auyHeights[i]; ++j)
+        {
+            const Grid::EPlayerMark CePlayerMark = Cgrid[GetHeight() - 1 - j][i];
+
+            SetBit(_amaskPlayers[CePlayerMark - 1], GetBitIndex(i, j));
+            _ulKey ^= _pZobrist->GetKey(CePlayerMark, GetBitIndex(i, j));
+            _ulMirroredKey ^= _pZobrist->GetKey(CePlayerMark, GetBitIndex(GetWidth() - 1 - i, j));
+        }
+    }
+}
+
+
+/**
+ * @brief Conversion operator to grid
+ */
+template <typename TMask, typename TGeometry>
+Bitboard<TMask, TGeometry>::operator Grid() const
+{
+    Grid grid(GetWidth(), GetHeight(), GetCellsToWin());
+
+    for (uint8_t i = 0; i < GetWidth(); ++i)
+    {
+        for (uint8_t j = 0; j < _auyHeights[i]; ++j)
+            grid._auyCells[grid.GetCellIndex(GetHeight() - 1 - j, i)] = GetCell(GetHeight() - 1 - j, i);
+        grid._ayNextCell[i] = GetNextCell(i);
+    }
+    grid._uyEmptyCells = _uyEmptyCells;
+    grid._ePlayerMarkWinner = _ePlayerMarkWinner;
+
+    return grid;
+}
+
+
+/**
+ * @brief Makes a move in the bitboard
+ *
+ * @param CePlayerMark the mark of the player that makes the move
+ * @param uyPlayColumn the chosen column for the move
+ */
+template <typename TMask, typename TGeometry>
+void Bitboard<TMask, TGeometry>::MakeMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyPlayColumn)
+{
+    if (!IsValidMove(uyPlayColumn) || CePlayerMark == Grid::EPlayerMark::EMPTY)
+        throw std::domain_error("Play is not valid");
+
+    const uint16_t CurBitIndex = GetBitIndex(uyPlayColumn, _auyHeights[uyPlayColumn]);
+
+    SetBit(_amaskPlayers[CePlayerMark - 1], CurBitIndex);
+    _ulKey ^= _pZobrist->GetKey(CePlayerMark, CurBitIndex);
+    _ulMirroredKey ^= _pZobrist->GetKey(CePlayerMark,
+        GetBitIndex(GetWidth() - 1 - uyPlayColumn, _auyHeights[uyPlayColumn]));
+    ++_auyHeights[uyPlayColumn];
+    --_uyEmptyCells;
+
+    if (HasWinningLine(_amaskPlayers[CePlayerMark - 1], CurBitIndex)) _ePlayerMarkWinner = CePlayerMark;
+}
+
+
+/**
+ * @brief Takes back the last move made in a column
+ *
+ * @param uyPlayColumn the column of the move
+ */
+template <typename TMask, typename TGeometry>
+void Bitboard<TMask, TGeometry>::UndoMove(uint8_t uyPlayColumn)
+{
+    if (uyPlayColumn >= GetWidth() || _auyHeights[uyPlayColumn] == 0)
+        throw std::domain_error("Undo is not valid");
+
+    --_auyHeights[uyPlayColumn];
+    ++_uyEmptyCells;
+
+    const uint16_t CurBitIndex = GetBitIndex(uyPlayColumn, _auyHeights[uyPlayColumn]);
+    const Grid::EPlayerMark CePlayerMark = TestBit(_amaskPlayers[0], CurBitIndex) ?
+        Grid::EPlayerMark::PLAYER1 : Grid::EPlayerMark::PLAYER2;
+
+    ResetBit(_amaskPlayers[CePlayerMark - 1], CurBitIndex);
+    _ulKey ^= _pZobrist->GetKey(CePlayerMark, CurBitIndex);
+    _ulMirroredKey ^= _pZobrist->GetKey(CePlayerMark,
+        GetBitIndex(GetWidth() - 1 - uyPlayColumn, _auyHeights[uyPlayColumn]));
+
+    // No move can follow a winning one, so the game is undecided again
+    _ePlayerMarkWinner = Grid::EPlayerMark::EMPTY;
+}
+
+
+/**
+ * @brief Finds the threats of a player, the empty cells that would complete a line of the player
+ *
+ * @param CePlayerMark the mark of the player
+ * @return TMask the cells of the threats, whether they can be played right now or not
+ */
+template <typename TMask, typename TGeometry>
+TMask Bitboard<TMask, TGeometry>::GetThreats(const Grid::EPlayerMark& CePlayerMark) const noexcept
+{
+    const TMask& CmaskPlayer = _amaskPlayers[CePlayerMark - 1];
+    const uint8_t CuyWidth = GetWidth(), CuyHeight = GetHeight(), CuyCellsToWin = GetCellsToWin();
+    TMask maskThreats{};
+
+    if (CuyHeight >= CuyCellsToWin) maskThreats |= GetLineThreats(CmaskPlayer, 1);                 // Vertical
+    if (CuyWidth >= CuyCellsToWin) maskThreats |= GetLineThreats(CmaskPlayer, CuyHeight + 1);      // Horizontal
+    if (CuyWidth >= CuyCellsToWin && CuyHeight >= CuyCellsToWin)
+        maskThreats |= GetLineThreats(CmaskPlayer, CuyHeight) | GetLineThreats(CmaskPlayer, CuyHeight + 2);
+
+    // The unused bits on top of the columns may look like threats, but can never be played
+    return maskThreats & ~(_amaskPlayers[0] | _amaskPlayers[1]) & _maskCells;
+}
+
+
+/**
+ * @brief Finds the cells where the next marker of every column that is not full would land
+ *
+ * @return TMask the cells that can be played right now
+ */
+template <typename TMask, typename TGeometry>
+TMask Bitboard<TMask, TGeometry>::GetPlayableCells() const noexcept
+{
+    TMask maskPlayable{};
+
+    for (uint8_t i = 0; i < GetWidth(); ++i)
+        if (_auyHeights[i] < GetHeight()) SetBit(maskPlayable, GetBitIndex(i, _auyHeights[i]));
+
+    return maskPlayable;
+}
+
+
+/**
+ * @brief Checks if the cells of a player hold a winning line, given that they did not before the last move.
+ * A native word is checked whole, as a shift of it costs a single instruction, while a wider bitmask only
+ * has the lines through the last move checked
+ *
+ * @param CmaskPlayer the cells of the player that made the last move
+ * @param urBitIndex the bit of the cell of the last move
+ * @return true if the cells hold a winning line
+ * @return false if the cells do not hold a winning line
+ */
+template <typename TMask, typename TGeometry>
+bool Bitboard<TMask, TGeometry>::HasWinningLine(const TMask& CmaskPlayer, uint16_t urBitIndex) const noexcept
+{
+    const uint8_t CuyWidth = GetWidth(), CuyHeight = GetHeight(), CuyCellsToWin = GetCellsToWin();
+
+    if constexpr (std::is_same_v<TMask, uint64_t>)
+    {
+        // The game could not be won before the last move, so any line of the player goes through it
+        if (CuyHeight >= CuyCellsToWin && HasLine(CmaskPlayer, 1)) return true;                 // Vertical
+        if (CuyWidth >= CuyCellsToWin && HasLine(CmaskPlayer, CuyHeight + 1)) return true;      // Horizontal
+        if (CuyWidth >= CuyCellsToWin && CuyHeight >= CuyCellsToWin)
+            return (HasLine(CmaskPlayer, CuyHeight) || HasLine(CmaskPlayer, CuyHeight + 2));    // Diagonals
+
+        return false;
+    }
+    else
+    {
+        return (HasLineThrough(CmaskPlayer, urBitIndex, 1) ||               // Vertical
+            HasLineThrough(CmaskPlayer, urBitIndex, CuyHeight + 1) ||       // Horizontal
+            HasLineThrough(CmaskPlayer, urBitIndex, CuyHeight) ||           // Diagonals
+            HasLineThrough(CmaskPlayer, urBitIndex, CuyHeight + 2));
+    }
+}
+
+
+/**
+ * @brief Checks if a bitmask holds enough consecutive cells in a direction to win the game
+ *
+ * @param CmaskPlayer the cells of a player
+ * @param urShift the distance between two consecutive bits in the direction to check
+ * @return true if there is a winning line in the direction
+ * @return false if there is no winning line in the direction
+ */
+template <typename TMask, typename TGeometry>
+bool Bitboard<TMask, TGeometry>::HasLine(const TMask& CmaskPlayer, uint16_t urShift) const noexcept
+{
+    // Keep the cells that start a run of a given length, doubling the length on every step
+    TMask maskRuns = CmaskPlayer;
+    uint8_t uyLength = 1;
+
+    for (; uyLength * 2 <= GetCellsToWin(); uyLength *= 2) maskRuns &= maskRuns >> (uyLength * urShift);
+
+    // Two overlapping runs are enough to cover the remaining length
+    if (uyLength < GetCellsToWin()) maskRuns &= maskRuns >> ((GetCellsToWin() - uyLength) * urShift);
+
+    return static_cast<bool>(maskRuns);
+}
+
+
+/**
+ * @brief Checks if a bitmask holds enough consecutive cells through a cell in a direction to win the game
+ *
+ * @param CmaskPlayer the cells of a player, the cell itself among them
+ * @param urBitIndex the bit of the cell
+ * @param urShift the distance between two consecutive bits in the direction to check
+ * @return true if there is a winning line through the cell in the direction
+ * @return false if there is no winning line through the cell in the direction
+ */
+template <typename TMask, typename TGeometry>
+bool Bitboard<TMask, TGeometry>::HasLineThrough(const TMask& CmaskPlayer, uint16_t urBitIndex, uint16_t urShift)
+    const noexcept
+{
+    const uint8_t CuyCellsToWin = GetCellsToWin();
+    const uint16_t CurBitCount = GetBitCount(GetWidth(), GetHeight());
+    uint8_t uyLength = 1;
+
+    // Walk away from the cell both ways. The unused bit on top of every column is never set, so a run stops
+    // there instead of wrapping into the next column
+    for (uint16_t i = urBitIndex + urShift; uyLength < CuyCellsToWin && i < CurBitCount && TestBit(CmaskPlayer, i);
+        i += urShift) ++uyLength;
+    for (int16_t i = urBitIndex - urShift; uyLength < CuyCellsToWin && i >= 0 && TestBit(CmaskPlayer, i);
+        i -= urShift) ++uyLength;
+
+    return (uyLength >= CuyCellsToWin);
+}
+
+
+/**
+ * @brief Finds the cells that would complete a line of a player in a direction, occupied or not
+ *
+ * @param CmaskPlayer the cells of a player
+ * @param urShift the distance between two consecutive bits in the direction to check
+ * @return TMask the cells that complete a line in the direction
+ */
+template <typename TMask, typename TGeometry>
+TMask Bitboard<TMask, TGeometry>::GetLineThreats(const TMask& CmaskPlayer, uint16_t urShift) const noexcept
+{
+    // Cells followed by a run of a given length in the direction, from no run at all to one cell short of a line
+    std::array<TMask, Grid::SCuyMaxWidth> amaskRunsAfter;
+    amaskRunsAfter[0] = ~TMask{};
+    for (uint8_t i = 1; i < GetCellsToWin(); ++i)
+        amaskRunsAfter[i] = amaskRunsAfter[i - 1] & (CmaskPlayer >> (i * urShift));
+
+    // A cell completes a line if the runs before and after it add up to one cell short of a line
+    TMask maskRunsBefore = ~TMask{}, maskThreats{};
+    for (uint8_t i = 0; i < GetCellsToWin(); ++i)
+    {
+        if (i > 0) maskRunsBefore &= CmaskPlayer << (i * urShift);
+        maskThreats |= maskRunsBefore & amaskRunsAfter[GetCellsToWin() - 1 - i];
+    }
+
+    return maskThreats;
+}
+
+
+/* Bitmask types the board can be built upon, for any size and then for the common sizes */
+template class Bitboard<uint64_t>;
+template class Bitboard<Bitmask<2> >;
+template class Bitboard<Bitmask<4> >;
+template class Bitboard<uint64_t, Geometry<7, 6, 4> >;
+template class Bitboard<uint64_t, Geometry<8, 7, 4> >;
+template class Bitboard<Bitmask<2>, Geometry<9, 7, 5> >;
+template class Bitboard<Bitmask<2>, Geometry<10, 8, 5> >;
@@ -0,0 +1,237 @@
+/*
+EndgameSolver.cpp --- Exact win/draw/loss search for the end of a ConnectX game
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include "../../include/ai/EndgameSolver.hpp"
+#include "../../include/ai/Bitboard.hpp"
+#include "../../include/ai/Bitmask.hpp"
+#include "../../include/ai/Geometry.hpp"
+#include "../../include/ai/TranspositionTable.hpp"
+#include "../../include/ai/MoveOrdering.hpp"
+#include "../../include/Grid.hpp"
+
+
+/**
+ * @brief Construct a new solver
+ *
+ * @param uiTableSize the size of the transposition table of the solver in bytes
+ */
+EndgameSolver::EndgameSolver(uint32_t uiTableSize) : _transpositionTable{uiTableSize}, _moveOrdering{},
+    _ulNodeCount{0}, _timePointDeadline{}, _pbCancelled{nullptr}, _bStopped{false} {}
+
+
+/**
+ * @brief Finds the value of a position and a move that achieves it
+ *
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board to solve, which is left as it was found
+ * @param CePlayerMark the mark of the player to move
+ * @param uyBestMove the best column found
+ * @param CtimePointDeadline when the solve must be given up, if ever
+ * @param CpbCancelled a flag whoever asked for the solve may raise from any thread to give it up, if any
+ * @return int8_t the value of the position for the player to move, or SCyUnknown if the solve was given up,
+ * in which case the best move means nothing
+ */
+template <typename TMask, typename TGeometry>
+int8_t EndgameSolver::Solve(Bitboard<TMask, TGeometry>& bitboard, const Grid::EPlayerMark& CePlayerMark,
+    uint8_t& uyBestMove, const std::chrono::steady_clock::time_point& CtimePointDeadline,
+    const std::atomic<bool>* CpbCancelled) noexcept
+{
+    _ulNodeCount = 0;
+    _timePointDeadline = CtimePointDeadline;
+    _pbCancelled = CpbCancelled;
+    _bStopped = false;
+    _transpositionTable.NewSearch();
+    _moveOrdering.NewSearch();
+
+    int8_t yValue = Negamax(bitboard, CePlayerMark, 0, SCyLoss, SCyWin, uyBestMove);
+    _pbCancelled = nullptr;
+    if (_bStopped) return SCyUnknown;
+
+    // A lost position found in the table has no best move, but any valid one will do
+    if (uyBestMove == TranspositionTable::SCuyNoMove)
+    {
+        std::array<uint8_t, Grid::SCuyMaxWidth> auyMoves{};
+        if (_moveOrdering.GetMoves(bitboard, CePlayerMark, TranspositionTable::SCuyNoMove, 0, auyMoves) > 0)
+            uyBestMove = auyMoves[0];
+    }
+
+    return yValue;
+}
+
+
+/**
+ * @brief Negamax search with alpha-beta pruning to the end of the game. Immediate wins are taken without
+ * searching, a single threat of the opponent is blocked without trying anything else and no marker is
+ * played right under a threat of the opponent
+ *
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board being searched, which is left as it was found
+ * @param CePlayerMark the mark of this node's player
+ * @param uyPly the distance of the node from the root
+ * @param yAlpha the lowest value this node's player is already assured of
+ * @param yBeta the highest value the other player allows this node to get
+ * @param uyBestMove the best column found
+ * @return int8_t the value of the current node for this node's player
+ */
+template <typename TMask, typename TGeometry>
+int8_t EndgameSolver::Negamax(Bitboard<TMask, TGeometry>& bitboard, const Grid::EPlayerMark& CePlayerMark,
+    uint8_t uyPly, int8_t yAlpha, int8_t yBeta, uint8_t& uyBestMove) noexcept
+{
+    uyBestMove = TranspositionTable::SCuyNoMove;
+
+    // The clock and the request are looked at now and then, and once either ends the solve every node returns
+    if (++_ulNodeCount % SCuiStopCheckNodes == 0 && (std::chrono::steady_clock::now() >= _timePointDeadline ||
+        (_pbCancelled != nullptr && _pbCancelled->load(std::memory_order_relaxed))))
+        _bStopped = true;
+
+    if (_bStopped || bitboard.IsFull()) return SCyDraw;
+
+    const Grid::EPlayerMark CeOpponent = (CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+        Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+    const TMask CmaskPlayable = bitboard.GetPlayableCells();
+    const TMask CmaskWins = bitboard.GetThreats(CePlayerMark) & CmaskPlayable;
+    const TMask CmaskOpponentThreats = bitboard.GetThreats(CeOpponent);
+    const TMask CmaskForcedBlocks = CmaskOpponentThreats & CmaskPlayable;
+
+    // Children are never won positions, since every winning move is taken here
+    if (CmaskWins || CmaskForcedBlocks)
+    {
+        for (uint8_t i = 0; i < bitboard.GetWidth(); ++i)
+        {
+            if (bitboard.IsNextCellIn(CmaskWins, i))
+            {
+                uyBestMove = i;
+                return SCyWin;
+            }
+            else if (bitboard.IsNextCellIn(CmaskForcedBlocks, i)) uyBestMove = i;
+        }
+
+        // Only one threat can be blocked, and any other move loses at once
+        if (CountBits(CmaskForcedBlocks) > 1) return SCyLoss;
+
+        const uint8_t CuyBlock = uyBestMove;
+        uint8_t uyChildMove = TranspositionTable::SCuyNoMove;
+
+        bitboard.MakeMove(CePlayerMark, CuyBlock);
+        int8_t yValue = -Negamax(bitboard, CeOpponent, uyPly + 1, -yBeta, -yAlpha, uyChildMove);
+        bitboard.UndoMove(CuyBlock);
+
+        uyBestMove = CuyBlock;
+        return yValue;
+    }
+
+    uint8_t uyHashMove = TranspositionTable::SCuyNoMove;
+    TranspositionTable::Entry entry{};
+
+    // The value of a position does not depend on how it was searched, so any entry can be reused
+    if (_transpositionTable.Probe(bitboard.GetKey(), entry))
+    {
+        uyHashMove = bitboard.GetCanonicalMove(entry.uyMove);
+
+        if (entry.uyBound == TranspositionTable::EBound::EXACT)
+        {
+            uyBestMove = uyHashMove;
+            return entry.iScore;
+        }
+        else if (entry.uyBound == TranspositionTable::EBound::LOWER && entry.iScore > yAlpha) yAlpha = entry.iScore;
+        else if (entry.uyBound == TranspositionTable::EBound::UPPER && entry.iScore < yBeta) yBeta = entry.iScore;
+
+        if (yAlpha >= yBeta)
+        {
+            uyBestMove = uyHashMove;
+            return entry.iScore;
+        }
+    }
+
+    const int8_t CyAlphaStart = yAlpha;
+    int8_t yBestValue = SCyLoss;
+
+    std::array<uint8_t, Grid::SCuyMaxWidth> auyMoves{};
+    uint8_t uyMoveCount = _moveOrdering.GetMoves(bitboard, CePlayerMark, uyHashMove, uyPly, auyMoves);
+
+    // A marker right under a threat of the opponent lets it be played next, so such moves are lost already
+    const TMask CmaskUnderThreats = (CmaskOpponentThreats >> 1) & CmaskPlayable;
+    uint8_t uyKeptCount = 0;
+
+    for (uint8_t i = 0; i < uyMoveCount; ++i)
+        if (!bitboard.IsNextCellIn(CmaskUnderThreats, auyMoves[i])) auyMoves[uyKeptCount++] = auyMoves[i];
+
+    uyBestMove = auyMoves[0];
+    if (uyKeptCount == 0) return SCyLoss;
+    uyMoveCount = uyKeptCount;
+
+    for (uint8_t i = 0; i < uyMoveCount; ++i)
+    {
+        const uint8_t CuyColumn = auyMoves[i];
+        uint8_t uyChildMove = TranspositionTable::SCuyNoMove;
+
+        bitboard.MakeMove(CePlayerMark, CuyColumn);
+        int8_t yValue = -Negamax(bitboard, CeOpponent, uyPly + 1, -yBeta, -yAlpha, uyChildMove);
+        bitboard.UndoMove(CuyColumn);
+
+        if (_bStopped) return SCyDraw;  // Unfinished results are not stored
+        if (yValue > yBestValue)
+        {
+            yBestValue = yValue;
+            uyBestMove = CuyColumn;
+        }
+        if (yValue > yAlpha) yAlpha = yValue;
+
+        if (yAlpha >= yBeta)
+        {
+            _moveOrdering.AddCutoff(CePlayerMark, CuyColumn, bitboard.GetNextCell(CuyColumn), uyPly,
+                bitboard.GetEmptyCells());
+            break;
+        }
+    }
+
+    // The number of empty cells stands for the depth, so that larger subtrees are kept in the table
+    TranspositionTable::EBound eBound = TranspositionTable::EBound::EXACT;
+    if (yBestValue <= CyAlphaStart) eBound = TranspositionTable::EBound::UPPER;
+    else if (yBestValue >= yBeta) eBound = TranspositionTable::EBound::LOWER;
+
+    _transpositionTable.Store(bitboard.GetKey(), bitboard.GetEmptyCells(), eBound, yBestValue,
+        eBound == TranspositionTable::EBound::UPPER ? TranspositionTable::SCuyNoMove :
+        bitboard.GetCanonicalMove(uyBestMove));
+
+    return yBestValue;
+}
+
+
+/* Bitmask types the board can be built upon, for any size and then for the common sizes */
+template int8_t EndgameSolver::Solve(Bitboard<uint64_t>&, const Grid::EPlayerMark&, uint8_t&,
+    const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<Bitmask<2> >&, const Grid::EPlayerMark&, uint8_t&,
+    const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<Bitmask<4> >&, const Grid::EPlayerMark&, uint8_t&,
+    const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<uint64_t, Geometry<7, 6, 4> >&, const Grid::EPlayerMark&,
+    uint8_t&, const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<uint64_t, Geometry<8, 7, 4> >&, const Grid::EPlayerMark&,
+    uint8_t&, const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<Bitmask<2>, Geometry<9, 7, 5> >&, const Grid::EPlayerMark&,
+    uint8_t&, const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
+template int8_t EndgameSolver::Solve(Bitboard<Bitmask<2>, Geometry<10, 8, 5> >&, const Grid::EPlayerMark&,
+    uint8_t&, const std::chrono::steady_clock::time_point&, const std::atomic<bool>*) noexcept;
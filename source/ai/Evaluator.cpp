@@ -0,0 +1,300 @@
+/*
+Evaluator.cpp --- Incremental evaluation function for the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include "../../include/ai/Evaluator.hpp"
+#include "../../include/ai/WindowTable.hpp"
+#include "../../include/Grid.hpp"
+
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+
+
+/**
+ * @brief Construct an evaluator for an empty grid of no cells
+ */
+Evaluator::Evaluator() noexcept : _pWindowTable{nullptr}, _vectorauyWindowCounts{}, _vectorePlayerMarks{},
+    _vectoruyThreats{}, _iScore{0}, _iParityScore{0} {}
+
+
+/**
+ * @brief Construct an evaluator for the position of a grid
+ *
+ * @param Cgrid the grid to evaluate
+ */
+Evaluator::Evaluator(const Grid& Cgrid) :
+    _pWindowTable{&WindowTable::GetInstance(Cgrid.GetWidth(), Cgrid.GetHeight(), Cgrid.GetCellsToWin())},
+    _vectorauyWindowCounts(_pWindowTable->GetWindowCount(), {0, 0}),
+    _vectorePlayerMarks(_pWindowTable->GetCellCount(), Grid::EPlayerMark::EMPTY),
+    _vectoruyThreats(2 * _pWindowTable->GetCellCount(), 0), _iScore{0}, _iParityScore{0}
+{
+    for (uint16_t i = 0; i < _pWindowTable->GetCellCount(); ++i)
+        _vectorePlayerMarks[i] = Cgrid[i % Cgrid.GetHeight()][i / Cgrid.GetHeight()];
+
+    for (uint16_t i = 0; i < _pWindowTable->GetWindowCount(); ++i)
+    {
+        for (uint16_t urCell : _pWindowTable->GetWindowCells(i))
+        {
+            if (_vectorePlayerMarks[urCell] != Grid::EPlayerMark::EMPTY)
+                ++_vectorauyWindowCounts[i][_vectorePlayerMarks[urCell] - 1];
+        }
+
+        const uint8_t CuyCount1 = _vectorauyWindowCounts[i][0], CuyCount2 = _vectorauyWindowCounts[i][1];
+        if (IsThreatWindow(CuyCount1, CuyCount2)) AddThreat(Grid::EPlayerMark::PLAYER1, GetEmptyCell(i));
+        if (IsThreatWindow(CuyCount2, CuyCount1)) AddThreat(Grid::EPlayerMark::PLAYER2, GetEmptyCell(i));
+    }
+
+    _iScore = ScoreWindows();
+}
+
+
+/**
+ * @brief Gets the value of the position
+ *
+ * @param CePlayerMark the mark of the player the value is meant for
+ * @return int32_t the value of the position for the player
+ */
+int32_t Evaluator::GetScore(const Grid::EPlayerMark& CePlayerMark) const noexcept
+{
+    return (CePlayerMark == Grid::EPlayerMark::PLAYER1 ? _iScore + _iParityScore : -_iScore - _iParityScore);
+}
+
+
+/**
+ * @brief Places a marker on a cell
+ *
+ * @param CePlayerMark the mark of the player that places the marker
+ * @param uyColumn the column of the cell
+ * @param uyRow the row of the cell, counting from the top as in the grid
+ */
+void Evaluator::MakeMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) noexcept
+{
+    const Grid::EPlayerMark CeOtherMark = (CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+        Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+    const uint16_t CurCell = _pWindowTable->GetCell(uyColumn, uyRow);
+    const uint8_t CuyCellsToWin = _pWindowTable->GetCellsToWin();
+
+    _vectorePlayerMarks[CurCell] = CePlayerMark;    // So that it is not taken for the empty cell of a new threat
+
+    for (uint16_t urWindow : _pWindowTable->GetCellWindows(CurCell))
+    {
+        std::array<uint8_t, 2>& auyCounts = _vectorauyWindowCounts[urWindow];
+        const uint8_t CuyOwnCount = auyCounts[CePlayerMark - 1], CuyOtherCount = auyCounts[CeOtherMark - 1];
+
+        _iScore -= GetWindowScore(auyCounts[0], auyCounts[1]);
+        ++auyCounts[CePlayerMark - 1];
+        _iScore += GetWindowScore(auyCounts[0], auyCounts[1]);
+
+        // A threat can only be lost by filling its cell, and the cell of a new one is the one left empty
+        if (CuyOtherCount == 0 && CuyOwnCount + 2 == CuyCellsToWin) AddThreat(CePlayerMark, GetEmptyCell(urWindow));
+        else if (CuyOtherCount == 0 && CuyOwnCount + 1 == CuyCellsToWin) RemoveThreat(CePlayerMark, CurCell);
+        if (CuyOwnCount == 0 && CuyOtherCount + 1 == CuyCellsToWin) RemoveThreat(CeOtherMark, CurCell);
+    }
+}
+
+
+/**
+ * @brief Takes back a marker from a cell
+ *
+ * @param CePlayerMark the mark of the player that placed the marker
+ * @param uyColumn the column of the cell
+ * @param uyRow the row of the cell, counting from the top as in the grid
+ */
+void Evaluator::UndoMove(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow) noexcept
+{
+    const Grid::EPlayerMark CeOtherMark = (CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+        Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+    const uint16_t CurCell = _pWindowTable->GetCell(uyColumn, uyRow);
+    const uint8_t CuyCellsToWin = _pWindowTable->GetCellsToWin();
+
+    for (uint16_t urWindow : _pWindowTable->GetCellWindows(CurCell))
+    {
+        std::array<uint8_t, 2>& auyCounts = _vectorauyWindowCounts[urWindow];
+        const uint8_t CuyOwnCount = auyCounts[CePlayerMark - 1], CuyOtherCount = auyCounts[CeOtherMark - 1];
+
+        _iScore -= GetWindowScore(auyCounts[0], auyCounts[1]);
+        --auyCounts[CePlayerMark - 1];
+        _iScore += GetWindowScore(auyCounts[0], auyCounts[1]);
+
+        // The cell is still taken, so a lost threat is on the other empty cell and a new one is on this cell
+        if (CuyOtherCount == 0 && CuyOwnCount == CuyCellsToWin) AddThreat(CePlayerMark, CurCell);
+        else if (CuyOtherCount == 0 && CuyOwnCount + 1 == CuyCellsToWin)
+            RemoveThreat(CePlayerMark, GetEmptyCell(urWindow));
+        if (CuyOwnCount == 1 && CuyOtherCount + 1 == CuyCellsToWin) AddThreat(CeOtherMark, CurCell);
+    }
+
+    _vectorePlayerMarks[CurCell] = Grid::EPlayerMark::EMPTY;
+}
+
+
+/**
+ * @brief Scores every window from its counts, rather than from the value kept up to date, a batch of windows
+ * at a time with vector instructions where the target has them
+ *
+ * @return int32_t the value of the position for the first player
+ */
+int32_t Evaluator::ScoreWindows() const noexcept
+{
+    #ifdef __SSE2__
+        static_assert(sizeof(std::array<uint8_t, 2>) == 2, "The counts of a window must fill a 16-bit lane");
+
+        // The two counts of a window read as one 16-bit lane, c1 + 256 * c2 on x86, so a lane equal to c is a
+        // window open to the first player with c markers, and a lane equal to 256 * c one open to the second
+        const char* CpcCounts = reinterpret_cast<const char*>(_vectorauyWindowCounts.data());
+        const size_t CzWindows = _vectorauyWindowCounts.size(), CzBatchWindows = CzWindows / 8 * 8;
+        int32_t iScore = 0;
+
+        for (uint8_t c = 1; CzBatchWindows > 0 && c <= _pWindowTable->GetCellsToWin(); ++c)
+        {
+            const __m128i CxmmOpen1 = _mm_set1_epi16(c), CxmmOpen2 = _mm_set1_epi16(c << 8);
+            __m128i xmmOpen = _mm_setzero_si128();  // Windows open to the first player minus the second, per lane
+
+            for (size_t i = 0; i < CzBatchWindows; i += 8)
+            {
+                const __m128i CxmmCounts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(CpcCounts + 2 * i));
+
+                // Every matching lane is all ones, that is minus one
+                xmmOpen = _mm_sub_epi16(xmmOpen, _mm_cmpeq_epi16(CxmmCounts, CxmmOpen1));
+                xmmOpen = _mm_add_epi16(xmmOpen, _mm_cmpeq_epi16(CxmmCounts, CxmmOpen2));
+            }
+
+            // The lanes are widened to 32 bits in pairs and then summed across
+            __m128i xmmSum = _mm_madd_epi16(xmmOpen, _mm_set1_epi16(1));
+            xmmSum = _mm_add_epi32(xmmSum, _mm_shuffle_epi32(xmmSum, _MM_SHUFFLE(1, 0, 3, 2)));
+            xmmSum = _mm_add_epi32(xmmSum, _mm_shuffle_epi32(xmmSum, _MM_SHUFFLE(2, 3, 0, 1)));
+            iScore += SCaiWindowScores[c] * _mm_cvtsi128_si32(xmmSum);
+        }
+
+        // The windows left over from the last batch are scored one by one
+        for (size_t i = CzBatchWindows; i < CzWindows; ++i)
+            iScore += GetWindowScore(_vectorauyWindowCounts[i][0], _vectorauyWindowCounts[i][1]);
+
+        return iScore;
+    #else
+        return ScoreWindowsScalar();
+    #endif
+}
+
+
+/**
+ * @brief Scores every window from its counts one by one, as targets without vector instructions do
+ *
+ * @return int32_t the value of the position for the first player
+ */
+int32_t Evaluator::ScoreWindowsScalar() const noexcept
+{
+    int32_t iScore = 0;
+
+    for (const std::array<uint8_t, 2>& CauyCounts : _vectorauyWindowCounts)
+        iScore += GetWindowScore(CauyCounts[0], CauyCounts[1]);
+
+    return iScore;
+}
+
+
+/**
+ * @brief Gets the value of a window for the first player
+ *
+ * @param uyCount1 the markers of the first player in the window
+ * @param uyCount2 the markers of the second player in the window
+ * @return int32_t the value of the window for the first player
+ */
+int32_t Evaluator::GetWindowScore(uint8_t uyCount1, uint8_t uyCount2) const noexcept
+{
+    // A window with markers of both players can no longer be completed by either
+    if (uyCount2 == 0) return SCaiWindowScores[uyCount1];
+    else if (uyCount1 == 0) return -SCaiWindowScores[uyCount2];
+    else return 0;
+}
+
+
+/**
+ * @brief Checks if a window is one marker short of a line of a player
+ *
+ * @param uyCount the markers of the player in the window
+ * @param uyOtherCount the markers of the other player in the window
+ * @return true if the only empty cell of the window completes a line of the player
+ * @return false if the window holds more than one empty cell or markers of the other player
+ */
+bool Evaluator::IsThreatWindow(uint8_t uyCount, uint8_t uyOtherCount) const noexcept
+{
+    return (uyCount + 1 == _pWindowTable->GetCellsToWin() && uyOtherCount == 0);
+}
+
+
+/**
+ * @brief Finds the empty cell of a window that is one marker short of a line
+ *
+ * @param urWindow the number of the window
+ * @return uint16_t the number of the empty cell
+ */
+uint16_t Evaluator::GetEmptyCell(uint16_t urWindow) const noexcept
+{
+    for (uint16_t urCell : _pWindowTable->GetWindowCells(urWindow))
+        if (_vectorePlayerMarks[urCell] == Grid::EPlayerMark::EMPTY) return urCell;
+
+    return _pWindowTable->GetWindowCells(urWindow)[0];  // Never reached for a window short of a single marker
+}
+
+
+/**
+ * @brief Counts one more line completed by a cell for a player
+ *
+ * @param CePlayerMark the mark of the player
+ * @param urCell the number of the cell
+ */
+void Evaluator::AddThreat(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) noexcept
+{
+    if (_vectoruyThreats[2 * urCell + CePlayerMark - 1]++ == 0)
+        _iParityScore += GetParityScore(CePlayerMark, urCell);
+}
+
+
+/**
+ * @brief Counts one line less completed by a cell for a player
+ *
+ * @param CePlayerMark the mark of the player
+ * @param urCell the number of the cell
+ */
+void Evaluator::RemoveThreat(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) noexcept
+{
+    if (--_vectoruyThreats[2 * urCell + CePlayerMark - 1] == 0)
+        _iParityScore -= GetParityScore(CePlayerMark, urCell);
+}
+
+
+/**
+ * @brief Gets the parity value of a threat, which is only worth something on the rows that favour its player
+ *
+ * @param CePlayerMark the mark of the player of the threat
+ * @param urCell the number of the cell of the threat
+ * @return int32_t the value of the threat for the first player
+ */
+int32_t Evaluator::GetParityScore(const Grid::EPlayerMark& CePlayerMark, uint16_t urCell) const noexcept
+{
+    // Rows are counted from 1 at the bottom, the first player favouring odd rows and the second one even rows
+    const bool CbOddRow = (_pWindowTable->GetHeight() - urCell % _pWindowTable->GetHeight()) % 2 == 1;
+
+    if (CePlayerMark == Grid::EPlayerMark::PLAYER1) return (CbOddRow ? SCiParityScore : 0);
+    else return (CbOddRow ? 0 : -SCiParityScore);
+}
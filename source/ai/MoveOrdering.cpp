@@ -0,0 +1,152 @@
+/*
+MoveOrdering.cpp --- Move ordering heuristics for the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include "../../include/ai/MoveOrdering.hpp"
+#include "../../include/ai/Bitboard.hpp"
+#include "../../include/ai/Bitmask.hpp"
+#include "../../include/ai/Geometry.hpp"
+#include "../../include/ai/TranspositionTable.hpp"
+#include "../../include/Grid.hpp"
+
+
+/**
+ * @brief Construct a new move ordering with no killers and no history
+ */
+MoveOrdering::MoveOrdering() noexcept : _aauyKillers{}, _aauiHistory{}
+{
+    for (std::array<uint8_t, 2>& auyKillers : _aauyKillers)
+        auyKillers = {TranspositionTable::SCuyNoMove, TranspositionTable::SCuyNoMove};
+}
+
+
+/**
+ * @brief Gets the valid moves of a node, best candidates first
+ *
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param Cbitboard the board of the node
+ * @param CePlayerMark the mark of the player to move
+ * @param uyHashMove the best move stored in the transposition table, if any
+ * @param uyPly the distance of the node from the root
+ * @param auyMoves the sorted moves
+ * @return uint8_t the number of valid moves
+ */
+template <typename TMask, typename TGeometry>
+uint8_t MoveOrdering::GetMoves(const Bitboard<TMask, TGeometry>& Cbitboard, const Grid::EPlayerMark& CePlayerMark,
+    uint8_t uyHashMove, uint8_t uyPly, std::array<uint8_t, Grid::SCuyMaxWidth>& auyMoves) const noexcept
+{
+    std::array<uint32_t, Grid::SCuyMaxWidth> auiScores{};
+    uint8_t uyMoveCount = 0;
+    const uint8_t CuyCentre = (Cbitboard.GetWidth() - 1) / 2;
+
+    for (uint8_t i = 0; i < Cbitboard.GetWidth(); ++i)
+    {
+        // Columns are visited from the centre outwards, so that ties are broken in favour of the centre
+        uint8_t uyColumn = (i % 2 == 0 ? CuyCentre - i / 2 : CuyCentre + (i + 1) / 2);
+
+        if (Cbitboard.IsValidMove(uyColumn))
+        {
+            uint32_t uiScore = 0;
+            if (uyColumn == uyHashMove) uiScore = SCuiHashScore;
+            else if (uyColumn == _aauyKillers[uyPly][0]) uiScore = SCuiKillerScore;
+            else if (uyColumn == _aauyKillers[uyPly][1]) uiScore = SCuiKillerScore - 1;
+            else uiScore = _aauiHistory[CePlayerMark - 1]
+                [uyColumn * Grid::SCuyMaxHeight + Cbitboard.GetNextCell(uyColumn)];
+
+            // Insertion sort, which keeps the centre-out order among equal scores
+            uint8_t j = uyMoveCount++;
+            for (; j > 0 && auiScores[j - 1] < uiScore; --j)
+            {
+                auyMoves[j] = auyMoves[j - 1];
+                auiScores[j] = auiScores[j - 1];
+            }
+            auyMoves[j] = uyColumn;
+            auiScores[j] = uiScore;
+        }
+    }
+
+    return uyMoveCount;
+}
+
+
+/**
+ * @brief Rewards a move that caused a cutoff
+ *
+ * @param CePlayerMark the mark of the player that made the move
+ * @param uyColumn the column of the move
+ * @param uyRow the row the marker landed on
+ * @param uyPly the distance of the node from the root
+ * @param uyDepthLeft the remaining depth of the node
+ */
+void MoveOrdering::AddCutoff(const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn, uint8_t uyRow,
+    uint8_t uyPly, uint8_t uyDepthLeft) noexcept
+{
+    std::array<uint8_t, 2>& auyKillers = _aauyKillers[uyPly];
+    if (auyKillers[0] != uyColumn)
+    {
+        auyKillers[1] = auyKillers[0];
+        auyKillers[0] = uyColumn;
+    }
+
+    // Cutoffs far from the leaves prune larger subtrees, so they weigh more
+    uint32_t& uiHistory = _aauiHistory[CePlayerMark - 1][uyColumn * Grid::SCuyMaxHeight + uyRow];
+    uiHistory += static_cast<uint32_t>(uyDepthLeft) * uyDepthLeft;
+    if (uiHistory >= SCuiMaxHistory) FadeHistory();
+}
+
+
+/**
+ * @brief Prepares for a new search, forgetting the killers and fading the history
+ */
+void MoveOrdering::NewSearch() noexcept
+{
+    for (std::array<uint8_t, 2>& auyKillers : _aauyKillers)
+        auyKillers = {TranspositionTable::SCuyNoMove, TranspositionTable::SCuyNoMove};
+
+    FadeHistory();
+}
+
+
+/**
+ * @brief Halves every history score
+ */
+void MoveOrdering::FadeHistory() noexcept
+{
+    for (std::array<uint32_t, Grid::SCuyMaxCells>& auiHistory : _aauiHistory)
+        for (uint32_t& uiHistory : auiHistory) uiHistory /= 2;
+}
+
+
+/* Bitmask types the board can be built upon, for any size and then for the common sizes */
+template uint8_t MoveOrdering::GetMoves(const Bitboard<uint64_t>&, const Grid::EPlayerMark&, uint8_t, uint8_t,
+    std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<Bitmask<2> >&, const Grid::EPlayerMark&, uint8_t,
+    uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<Bitmask<4> >&, const Grid::EPlayerMark&, uint8_t,
+    uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<uint64_t, Geometry<7, 6, 4> >&, const Grid::EPlayerMark&,
+    uint8_t, uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<uint64_t, Geometry<8, 7, 4> >&, const Grid::EPlayerMark&,
+    uint8_t, uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<Bitmask<2>, Geometry<9, 7, 5> >&, const Grid::EPlayerMark&,
+    uint8_t, uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
+template uint8_t MoveOrdering::GetMoves(const Bitboard<Bitmask<2>, Geometry<10, 8, 5> >&, const Grid::EPlayerMark&,
+    uint8_t, uint8_t, std::array<uint8_t, Grid::SCuyMaxWidth>&) const noexcept;
@@ -0,0 +1,207 @@
+/*
+OpeningBook.cpp --- Precomputed first moves of the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include "../../include/ai/OpeningBook.hpp"
+#include "../../include/ai/Bitboard.hpp"
+#include "../../include/ai/Bitmask.hpp"
+#include "../../include/ai/Geometry.hpp"
+#include "../../include/ai/TranspositionTable.hpp"
+
+
+/** Signature at the start of a book file */
+const char OpeningBook::SCacMagic[4] = {'C', 'X', 'O', 'B'};
+
+
+/**
+ * @brief Construct an empty book for a board geometry
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ * @param uyCellsToWin the number of markers in a row needed to win
+ */
+OpeningBook::OpeningBook(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin) noexcept : _uyWidth{uyWidth},
+    _uyHeight{uyHeight}, _uyCellsToWin{uyCellsToWin}, _vectorEntries{} {}
+
+
+/**
+ * @brief Constructs a new book by reading a book file
+ *
+ * @param CsFilePath the path to the book file
+ */
+OpeningBook::OpeningBook(const std::string& CsFilePath) : _uyWidth{0}, _uyHeight{0}, _uyCellsToWin{0},
+    _vectorEntries{}
+{
+    std::ifstream ifstreamBook{CsFilePath, std::ios_base::binary};
+    std::array<uint8_t, 12> auyHeader{};    // Magic, version, geometry and number of positions
+
+    if (!ifstreamBook.read(reinterpret_cast<char*>(auyHeader.data()), auyHeader.size()))
+        throw std::ios_base::failure("Error: Could not read the book header");
+    if (!std::equal(SCacMagic, SCacMagic + 4, auyHeader.begin()) || auyHeader[4] != SCuyVersion)
+        throw std::ios_base::failure("Error: Not a book file");
+
+    _uyWidth = auyHeader[5];
+    _uyHeight = auyHeader[6];
+    _uyCellsToWin = auyHeader[7];
+
+    const uint32_t CuiSize = auyHeader[8] | (auyHeader[9] << 8) | (auyHeader[10] << 16) |
+        (static_cast<uint32_t>(auyHeader[11]) << 24);
+
+    // The number of positions is checked against what is left of the file before any memory is taken for them
+    const std::streampos CstreamPosEntries = ifstreamBook.tellg();
+    if (CstreamPosEntries == std::streampos(-1) || !ifstreamBook.seekg(0, std::ios_base::end))
+        throw std::ios_base::failure("Error: Could not measure the book file");
+    const std::streamoff CstreamOffLeft = ifstreamBook.tellg() - CstreamPosEntries;
+    if (CstreamOffLeft < 0 || static_cast<uint64_t>(CstreamOffLeft) / SCuyEntrySize < CuiSize ||
+        !ifstreamBook.seekg(CstreamPosEntries))
+        throw std::ios_base::failure("Error: The book file is truncated");
+
+    _vectorEntries.reserve(CuiSize);
+
+    /* Every position is its key followed by its column */
+    for (uint32_t i = 0; i < CuiSize; ++i)
+    {
+        std::array<uint8_t, SCuyEntrySize> auyEntry{};
+        if (!ifstreamBook.read(reinterpret_cast<char*>(auyEntry.data()), auyEntry.size()))
+            throw std::ios_base::failure("Error: The book file is truncated");
+
+        Entry entry{0, auyEntry[8]};
+        for (uint8_t j = 0; j < 8; ++j) entry.ulKey |= static_cast<uint64_t>(auyEntry[j]) << (j * 8);
+        _vectorEntries.push_back(entry);
+    }
+
+    // Books are written sorted, but a hand-made one might not be
+    std::sort(_vectorEntries.begin(), _vectorEntries.end(),
+        [](const Entry& Centry1, const Entry& Centry2) { return Centry1.ulKey < Centry2.ulKey; });
+}
+
+
+/**
+ * @brief Gets the name of the book file of a board geometry
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ * @param uyCellsToWin the number of markers in a row needed to win
+ * @return std::string the file name, with no directory
+ */
+std::string OpeningBook::GetFileName(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin)
+{
+    return "book_" + std::to_string(uyWidth) + "x" + std::to_string(uyHeight) + "_" +
+        std::to_string(uyCellsToWin) + ".bin";
+}
+
+
+/**
+ * @brief Saves the book on disk
+ *
+ * @param CsFilePath the path where the book is to be stored
+ */
+void OpeningBook::Save(const std::string& CsFilePath) const
+{
+    std::ofstream ofstreamBook{CsFilePath, std::ios_base::binary | std::ios_base::trunc};
+    const uint32_t CuiSize = _vectorEntries.size();
+
+    std::array<uint8_t, 12> auyHeader{static_cast<uint8_t>(SCacMagic[0]), static_cast<uint8_t>(SCacMagic[1]),
+        static_cast<uint8_t>(SCacMagic[2]), static_cast<uint8_t>(SCacMagic[3]), SCuyVersion, _uyWidth, _uyHeight,
+        _uyCellsToWin, static_cast<uint8_t>(CuiSize), static_cast<uint8_t>(CuiSize >> 8),
+        static_cast<uint8_t>(CuiSize >> 16), static_cast<uint8_t>(CuiSize >> 24)};
+    ofstreamBook.write(reinterpret_cast<const char*>(auyHeader.data()), auyHeader.size());
+
+    for (const Entry& Centry : _vectorEntries)
+    {
+        std::array<uint8_t, SCuyEntrySize> auyEntry{};
+        for (uint8_t j = 0; j < 8; ++j) auyEntry[j] = static_cast<uint8_t>(Centry.ulKey >> (j * 8));
+        auyEntry[8] = Centry.uyMove;
+
+        ofstreamBook.write(reinterpret_cast<const char*>(auyEntry.data()), auyEntry.size());
+    }
+
+    if (!ofstreamBook.flush()) throw std::ios_base::failure("I/O Error");
+}
+
+
+/**
+ * @brief Stores the best move of a position, replacing the one stored before if any
+ *
+ * @param ulKey the Zobrist key of the position, which it shares with its mirror image
+ * @param uyMove the best column of the position, on the board the key stands for
+ */
+void OpeningBook::AddMove(uint64_t ulKey, uint8_t uyMove)
+{
+    std::vector<Entry>::const_iterator iteratorEntry = LowerBound(ulKey);
+
+    if (iteratorEntry != _vectorEntries.end() && iteratorEntry->ulKey == ulKey)
+        _vectorEntries[iteratorEntry - _vectorEntries.begin()].uyMove = uyMove;
+    else _vectorEntries.insert(iteratorEntry, Entry{ulKey, uyMove});
+}
+
+
+/**
+ * @brief Looks up the best move of a position
+ *
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param Cbitboard the board of the position
+ * @return uint8_t the best column, or TranspositionTable::SCuyNoMove if the book was made for another board
+ * geometry, does not hold the position or holds a move that is not valid
+ */
+template <typename TMask, typename TGeometry>
+uint8_t OpeningBook::Probe(const Bitboard<TMask, TGeometry>& Cbitboard) const noexcept
+{
+    if (Cbitboard.GetWidth() != _uyWidth || Cbitboard.GetHeight() != _uyHeight ||
+        Cbitboard.GetCellsToWin() != _uyCellsToWin) return TranspositionTable::SCuyNoMove;
+
+    std::vector<Entry>::const_iterator iteratorEntry = LowerBound(Cbitboard.GetKey());
+
+    if (iteratorEntry == _vectorEntries.end() || iteratorEntry->ulKey != Cbitboard.GetKey())
+        return TranspositionTable::SCuyNoMove;
+
+    // The move is stored for the board the key stands for, which may be the mirror image of this one
+    const uint8_t CuyMove = Cbitboard.GetCanonicalMove(iteratorEntry->uyMove);
+    return (Cbitboard.IsValidMove(CuyMove) ? CuyMove : TranspositionTable::SCuyNoMove);
+}
+
+
+/**
+ * @brief Finds the first entry whose key is not lower than a key
+ *
+ * @param ulKey the key to look for
+ * @return std::vector<Entry>::const_iterator the entry, or the end of the entries
+ */
+std::vector<OpeningBook::Entry>::const_iterator OpeningBook::LowerBound(uint64_t ulKey) const noexcept
+{
+    return std::lower_bound(_vectorEntries.begin(), _vectorEntries.end(), ulKey,
+        [](const Entry& Centry, uint64_t ulOtherKey) { return Centry.ulKey < ulOtherKey; });
+}
+
+
+/* Bitmask types the board can be built upon, for any size and then for the common sizes */
+template uint8_t OpeningBook::Probe(const Bitboard<uint64_t>&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<Bitmask<2> >&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<Bitmask<4> >&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<uint64_t, Geometry<7, 6, 4> >&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<uint64_t, Geometry<8, 7, 4> >&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<Bitmask<2>, Geometry<9, 7, 5> >&) const noexcept;
+template uint8_t OpeningBook::Probe(const Bitboard<Bitmask<2>, Geometry<10, 8, 5> >&) const noexcept;
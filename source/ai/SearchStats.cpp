@@ -0,0 +1,117 @@
+/*
+SearchStats.cpp --- Instrumentation of the ConnectX search
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <vector>
+#include <ostream>
+#include <ios>
+#include <iomanip>
+#include "../../include/ai/SearchStats.hpp"
+
+
+/**
+ * @brief Construct new statistics with no iterations
+ */
+SearchStats::SearchStats() : _vectorIterations{}
+{
+    #ifdef SEARCH_STATS
+        _vectorIterations.reserve(SCurMaxIterations);   // No search adds more, so counting never allocates
+    #endif
+}
+
+
+/**
+ * @brief Forgets the iterations of the last search
+ */
+void SearchStats::NewSearch() noexcept { _vectorIterations.clear(); }
+
+
+/**
+ * @brief Starts counting a new iteration
+ *
+ * @param uyDepth the plies the iteration searches
+ */
+void SearchStats::NewIteration([[maybe_unused]] uint8_t uyDepth) noexcept
+{
+    #ifdef SEARCH_STATS
+        if (_vectorIterations.size() < SCurMaxIterations)
+            _vectorIterations.push_back(Iteration{uyDepth, false, 0, 0, 0, 0, 0, 0});
+    #endif
+}
+
+
+/**
+ * @brief Marks the current iteration as finished before the search was stopped
+ */
+void SearchStats::EndIteration() noexcept
+{
+    if (!_vectorIterations.empty()) _vectorIterations.back().bComplete = true;
+}
+
+
+/**
+ * @brief Gets the effective branching factor of an iteration, that is, how many times more nodes it visited
+ * than the one before
+ *
+ * @param uyIteration the index of the iteration
+ * @return double the branching factor, or 0 for the first iteration or one following an empty one
+ */
+double SearchStats::GetBranchingFactor(uint8_t uyIteration) const noexcept
+{
+    if (uyIteration == 0 || uyIteration >= _vectorIterations.size() ||
+        _vectorIterations[uyIteration - 1].ulNodes == 0) return 0;
+
+    return static_cast<double>(_vectorIterations[uyIteration].ulNodes) / _vectorIterations[uyIteration - 1].ulNodes;
+}
+
+
+/**
+ * @brief Prints a line per iteration, narrow enough for the Wii console
+ *
+ * @param ostream the stream to print to
+ */
+void SearchStats::Print(std::ostream& ostream) const
+{
+    const std::ios_base::fmtflags CfmtFlags = ostream.flags();
+    const std::streamsize ClPrecision = ostream.precision();
+    bool bStopped = false;
+
+    ostream << "depth      nodes   ebf      evals  cutoffs 1st%     probes hit%\n";
+
+    for (uint16_t i = 0; i < _vectorIterations.size(); ++i)
+    {
+        const Iteration& Citeration = _vectorIterations[i];
+        const uint64_t CulCutoffs = (Citeration.ulCutoffs > 0 ? Citeration.ulCutoffs : 1);
+        const uint64_t CulTableProbes = (Citeration.ulTableProbes > 0 ? Citeration.ulTableProbes : 1);
+
+        ostream << std::setw(4) << static_cast<uint32_t>(Citeration.uyDepth) << (Citeration.bComplete ? ' ' : '*')
+            << std::setw(11) << Citeration.ulNodes << std::fixed << std::setprecision(2) << std::setw(6)
+            << GetBranchingFactor(i) << std::setw(11) << Citeration.ulEvaluations << std::setw(9)
+            << Citeration.ulCutoffs << std::setprecision(0) << std::setw(5)
+            << 100.0 * Citeration.ulFirstMoveCutoffs / CulCutoffs << std::setw(11) << Citeration.ulTableProbes
+            << std::setw(5) << 100.0 * Citeration.ulTableHits / CulTableProbes << '\n';
+
+        if (!Citeration.bComplete) bStopped = true;
+    }
+
+    if (bStopped) ostream << "* stopped before the end\n";
+    ostream.flags(CfmtFlags);
+    ostream.precision(ClPrecision);
+    ostream.flush();
+}
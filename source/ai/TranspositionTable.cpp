@@ -0,0 +1,151 @@
+/*
+TranspositionTable.cpp --- Cache of searched ConnectX positions
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "../../include/ai/TranspositionTable.hpp"
+
+
+/**
+ * @brief Construct a new table
+ *
+ * @param uiSize the maximum size of the table in bytes, rounded down to a power of two buckets
+ */
+TranspositionTable::TranspositionTable(uint32_t uiSize) : _pBuckets{}, _ulIndexMask{0}, _uyGeneration{0}
+{
+    uint32_t uiBucketCount = 1;
+    while (uiBucketCount * 2 <= uiSize / sizeof(Bucket)) uiBucketCount *= 2;
+
+    _pBuckets.reset(new Bucket[uiBucketCount]);
+    _ulIndexMask = uiBucketCount - 1;
+    Clear();
+}
+
+
+/**
+ * @brief Looks up a position
+ *
+ * @param ulKey the Zobrist key of the position
+ * @param entry the entry that was found, if any
+ * @return true if the position was found
+ * @return false if the position was not found
+ */
+bool TranspositionTable::Probe(uint64_t ulKey, Entry& entry) const noexcept
+{
+    const Bucket& Cbucket = _pBuckets[ulKey & _ulIndexMask];
+
+    for (const Slot& Cslot : Cbucket.aSlots)
+    {
+        Entry entryStored = Load(Cslot);
+
+        if (entryStored.ulKey == ulKey && entryStored.uyBound != EBound::NONE)
+        {
+            entry = entryStored;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/**
+ * @brief Stores the result of a search, replacing the least valuable entry of the bucket if needed
+ *
+ * @param ulKey the Zobrist key of the position
+ * @param uyDepth the remaining depth the position was searched to
+ * @param CeBound the type of bound of the score
+ * @param iScore the score found by the search
+ * @param uyMove the best column found, or SCuyNoMove
+ */
+void TranspositionTable::Store(uint64_t ulKey, uint8_t uyDepth, const EBound& CeBound, int32_t iScore,
+    uint8_t uyMove) noexcept
+{
+    Bucket& bucket = _pBuckets[ulKey & _ulIndexMask];
+    Slot* pSlotVictim = &bucket.aSlots[0];
+    Entry entryVictim = Load(*pSlotVictim);
+    uint16_t urVictimWorth = UINT16_MAX;
+
+    for (Slot& slot : bucket.aSlots)
+    {
+        Entry entry = Load(slot);
+
+        if (entry.ulKey == ulKey || entry.uyBound == EBound::NONE)  // Same position or free slot
+        {
+            pSlotVictim = &slot;
+            entryVictim = entry;
+            break;
+        }
+
+        // Entries from previous searches are worth less than any entry of the current one
+        uint16_t urWorth = entry.uyDepth + (entry.uyGeneration == _uyGeneration ? 256 : 0);
+        if (urWorth < urVictimWorth)
+        {
+            pSlotVictim = &slot;
+            entryVictim = entry;
+            urVictimWorth = urWorth;
+        }
+    }
+
+    // Keep the best move of a deeper search of the same position if this one did not find any
+    if (uyMove == SCuyNoMove && entryVictim.ulKey == ulKey) uyMove = entryVictim.uyMove;
+
+    const uint32_t CuiScore = static_cast<uint32_t>(iScore);
+    const uint32_t CuiInfo = uyDepth | (static_cast<uint32_t>(CeBound) << 8) |
+        (static_cast<uint32_t>(uyMove) << 16) | (static_cast<uint32_t>(_uyGeneration) << 24);
+
+    pSlotVictim->auiWords[0].store(static_cast<uint32_t>(ulKey >> 32) ^ CuiScore, std::memory_order_relaxed);
+    pSlotVictim->auiWords[1].store(static_cast<uint32_t>(ulKey) ^ CuiInfo, std::memory_order_relaxed);
+    pSlotVictim->auiWords[2].store(CuiScore, std::memory_order_relaxed);
+    pSlotVictim->auiWords[3].store(CuiInfo, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Empties the table
+ */
+void TranspositionTable::Clear() noexcept
+{
+    for (uint64_t i = 0; i <= _ulIndexMask; ++i)
+        for (Slot& slot : _pBuckets[i].aSlots)
+            for (std::atomic<uint32_t>& uiWord : slot.auiWords) uiWord.store(0, std::memory_order_relaxed);
+
+    _uyGeneration = 0;
+}
+
+
+/**
+ * @brief Reads an entry from the table
+ *
+ * @param Cslot the stored entry
+ * @return Entry the entry, with the key it was stored with
+ */
+TranspositionTable::Entry TranspositionTable::Load(const Slot& Cslot) noexcept
+{
+    const uint32_t CuiScore = Cslot.auiWords[2].load(std::memory_order_relaxed);
+    const uint32_t CuiInfo = Cslot.auiWords[3].load(std::memory_order_relaxed);
+    const uint64_t CulKey = (static_cast<uint64_t>(Cslot.auiWords[0].load(std::memory_order_relaxed) ^
+        CuiScore) << 32) | (Cslot.auiWords[1].load(std::memory_order_relaxed) ^ CuiInfo);
+
+    return Entry{CulKey, static_cast<int32_t>(CuiScore), static_cast<uint8_t>(CuiInfo),
+        static_cast<uint8_t>(CuiInfo >> 8), static_cast<uint8_t>(CuiInfo >> 16),
+        static_cast<uint8_t>(CuiInfo >> 24)};
+}
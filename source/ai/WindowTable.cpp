@@ -0,0 +1,105 @@
+/*
+WindowTable.cpp --- Winning windows of a ConnectX board geometry
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <map>
+#include <memory>
+
+#ifndef __wii__
+    #include <mutex>
+#endif
+
+#include "../../include/ai/WindowTable.hpp"
+
+
+/**
+ * @brief Gets the shared window table for a board geometry, building it on first use
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ * @param uyCellsToWin the number of markers in a row needed to win
+ * @return const WindowTable& the window table
+ */
+const WindowTable& WindowTable::GetInstance(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin)
+{
+    static std::map<uint32_t, std::unique_ptr<WindowTable> > SmapWindowTables{};   // Tables by geometry
+
+    #ifndef __wii__
+        // The Wii has a single searching thread, and the main thread builds its table before the first request
+        static std::mutex SmutexWindowTables{};
+        const std::lock_guard<std::mutex> ClockGuard{SmutexWindowTables};
+    #endif
+
+    std::unique_ptr<WindowTable>& pWindowTable =
+        SmapWindowTables[(uyWidth << 16) | (uyHeight << 8) | uyCellsToWin];
+    if (!pWindowTable) pWindowTable.reset(new WindowTable(uyWidth, uyHeight, uyCellsToWin));
+
+    return *pWindowTable;
+}
+
+
+/**
+ * @brief Builds the windows of a board geometry
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ * @param uyCellsToWin the number of markers in a row needed to win
+ */
+WindowTable::WindowTable(uint8_t uyWidth, uint8_t uyHeight, uint8_t uyCellsToWin) : _uyHeight{uyHeight},
+    _uyCellsToWin{uyCellsToWin}, _vectorurWindowCells{}, _vectorurCellOffsets(uyWidth * uyHeight + 1, 0),
+    _vectorurCellWindows{}
+{
+    // Column and row steps of the vertical, horizontal and both diagonal lines
+    static const std::array<std::array<int8_t, 2>, 4> SCaayDirections{{{0, 1}, {1, 0}, {1, 1}, {1, -1}}};
+
+    for (const std::array<int8_t, 2>& CayDirection : SCaayDirections)
+    {
+        // A window of a single cell is the same in every direction, so it is only taken horizontally
+        if (uyCellsToWin == 1 && CayDirection[1] != 0) continue;
+
+        for (int8_t i = 0; i < uyWidth; ++i)
+        {
+            for (int8_t j = 0; j < uyHeight; ++j)
+            {
+                const int8_t CyLastColumn = i + CayDirection[0] * (uyCellsToWin - 1);
+                const int8_t CyLastRow = j + CayDirection[1] * (uyCellsToWin - 1);
+                if (CyLastColumn >= uyWidth || CyLastRow < 0 || CyLastRow >= uyHeight) continue;
+
+                for (int8_t k = 0; k < uyCellsToWin; ++k)
+                {
+                    const uint16_t CurCell = GetCell(i + CayDirection[0] * k, j + CayDirection[1] * k);
+                    _vectorurWindowCells.push_back(CurCell);
+                    ++_vectorurCellOffsets[CurCell + 1];
+                }
+            }
+        }
+    }
+
+    /* Invert the windows into the windows through every cell */
+    for (uint16_t i = 1; i < _vectorurCellOffsets.size(); ++i)
+        _vectorurCellOffsets[i] += _vectorurCellOffsets[i - 1];
+
+    std::vector<uint16_t> vectorurNextWindow{_vectorurCellOffsets};
+    _vectorurCellWindows.resize(_vectorurWindowCells.size());
+
+    for (uint16_t i = 0; i < _vectorurWindowCells.size(); ++i)
+        _vectorurCellWindows[vectorurNextWindow[_vectorurWindowCells[i]]++] = i / uyCellsToWin;
+}
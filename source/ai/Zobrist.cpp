@@ -0,0 +1,75 @@
+/*
+Zobrist.cpp --- Zobrist keys for identifying ConnectX positions
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <memory>
+
+#ifndef __wii__
+    #include <mutex>
+#endif
+
+#include "../../include/ai/Zobrist.hpp"
+#include "../../include/ai/Bitboard.hpp"
+
+
+/**
+ * @brief Gets the shared key table for a board size, generating it on first use
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ * @return const Zobrist& the key table
+ */
+const Zobrist& Zobrist::GetInstance(uint8_t uyWidth, uint8_t uyHeight)
+{
+    static std::map<uint16_t, std::unique_ptr<Zobrist> > SmapZobrists{};  // Tables by board size
+
+    #ifndef __wii__     // Bitboards, and so their keys, are only built on the AI thread of the Wii
+        static std::mutex SmutexZobrists{};
+        const std::lock_guard<std::mutex> ClockGuard{SmutexZobrists};
+    #endif
+
+    std::unique_ptr<Zobrist>& pZobrist = SmapZobrists[(uyWidth << 8) | uyHeight];
+    if (!pZobrist) pZobrist.reset(new Zobrist(uyWidth, uyHeight));
+
+    return *pZobrist;
+}
+
+
+/**
+ * @brief Generates the keys for a board size
+ *
+ * @param uyWidth the width of the board
+ * @param uyHeight the height of the board
+ */
+Zobrist::Zobrist(uint8_t uyWidth, uint8_t uyHeight) :
+    _urBitCount{Bitboard<uint64_t>::GetBitCount(uyWidth, uyHeight)}, _vectorulKeys(2 * _urBitCount)
+{
+    // SplitMix64 generator seeded with the board size
+    uint64_t ulState = UINT64_C(0x9E3779B97F4A7C15) * ((uyWidth << 8) | uyHeight);
+
+    for (uint64_t& ulKey : _vectorulKeys)
+    {
+        ulKey = (ulState += UINT64_C(0x9E3779B97F4A7C15));
+        ulKey = (ulKey ^ (ulKey >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+        ulKey = (ulKey ^ (ulKey >> 27)) * UINT64_C(0x94D049BB133111EB);
+        ulKey ^= ulKey >> 31;
+    }
+}
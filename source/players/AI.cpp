@@ -19,17 +19,30 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstdint>
 #include <limits>
+#include <array>
 #include <algorithm>
 #include <stdexcept>
-#include <queue>
-#include <cmath>
+#include <vector>
+#include <atomic>
+#include <chrono>
 
-#include <SDL_mutex.h>
+#ifndef __wii__
+    #include <thread>
+    #include <system_error>
+#endif
 
 #include "../../include/players/AI.hpp"
 #include "../../include/players/Player.hpp"
 #include "../../include/Grid.hpp"
-#include "../../include/App.hpp"
+#include "../../include/ai/Bitboard.hpp"
+#include "../../include/ai/Bitmask.hpp"
+#include "../../include/ai/Geometry.hpp"
+#include "../../include/ai/TranspositionTable.hpp"
+#include "../../include/ai/MoveOrdering.hpp"
+#include "../../include/ai/EndgameSolver.hpp"
+#include "../../include/ai/Evaluator.hpp"
+#include "../../include/ai/OpeningBook.hpp"
+#include "../../include/ai/SearchStats.hpp"
 
 
 /**
@@ -37,356 +50,486 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
  *
  * @param CePlayerMark the mark assigned to this player
  * @param uySearchLimit the depth of levels that the AI will explore
+ * @param uyTableSize the size of the transposition table in MiB
+ * @param uyThreadCount the number of threads that search at the same time
+ * @param uiThinkTime the milliseconds the AI may search for every move, 0 for no limit
+ * @param CpOpeningBook the book of first moves to play without searching, if any, which must outlive the AI
  */
-AI::AI(const Grid::EPlayerMark& CePlayerMark, uint8_t uySearchLimit) : Player{CePlayerMark},
-    _uySearchLimit{uySearchLimit} {}
+AI::AI(const Grid::EPlayerMark& CePlayerMark, uint8_t uySearchLimit, uint8_t uyTableSize,
+    uint8_t uyThreadCount, uint32_t uiThinkTime, const OpeningBook* CpOpeningBook) : Player{CePlayerMark},
+    _uySearchLimit{uySearchLimit}, _uiThinkTime{uiThinkTime}, _timePointDeadline{},
+    _transpositionTable{static_cast<uint32_t>(uyTableSize) << 20}, _vectorSearchThreads{}, _bStopSearch{false},
+    _pbCancelled{nullptr}, _endgameSolver{SCuiSolverTableSize}, _pOpeningBook{CpOpeningBook}
+{
+    #ifdef __wii__
+        uyThreadCount = 1;  // Broadway has a single core
+    #endif
+
+    _vectorSearchThreads.resize(uyThreadCount > 0 ? uyThreadCount : 1);
+}
 
 
 /**
  * @brief Makes the AI choose a play on the board
  *
  * @param grid the main game board
+ * @param CpbCancelled a flag whoever asked for the move may raise from any thread to give up the search, which
+ * plays the best move found so far, if any
+ * @return uint8_t the column played, or TranspositionTable::SCuyNoMove if the grid is full
  */
-void AI::ChooseMove(Grid& grid) const noexcept
+uint8_t AI::ChooseMove(Grid& grid, const std::atomic<bool>* CpbCancelled) noexcept
 {
-    int32_t iAlpha = std::numeric_limits<int32_t>::min();
     uint8_t uyBestMove = 0;
 
-    for (uint8_t i = 0; i < _uySearchLimit && iAlpha < std::numeric_limits<int32_t>::max(); ++i)    // Iterative deepening search
+    _timePointDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_uiThinkTime);
+    _pbCancelled = CpbCancelled;
+    _transpositionTable.NewSearch();
+    for (SearchThread& searchThread : _vectorSearchThreads)
     {
-        iAlpha = std::numeric_limits<int32_t>::min();
-        uyBestMove = 0;
-
-        for (uint8_t j = 0; j < grid.GetWidth() && iAlpha < std::numeric_limits<int32_t>::max(); ++j)
-        {
-            if (grid.IsValidMove(j))
-            {
-                Grid gridAttempt = grid;
-                gridAttempt.MakeMove(__ePlayerMark, j);
-                int32_t iMinimaxValue = AlphaBetaPruning(gridAttempt, NextPlayer(__ePlayerMark), 1, i + 1,
-                    iAlpha, std::numeric_limits<int32_t>::max(), true);
-
-                if (iMinimaxValue > iAlpha)
-                {
-                    iAlpha = iMinimaxValue;
-                    uyBestMove = j;
-                }
-            }
-        }
+        searchThread.evaluator = Evaluator{grid};
+        searchThread.moveOrdering.NewSearch();
+        searchThread.ulNodeCount = 0;
+        searchThread.uyDepthReached = 0;
+        searchThread.searchStats.NewSearch();
     }
 
+    uyBestMove = WithBitboard(grid, [this](const auto& Cbitboard) { return SearchBestMove(Cbitboard); });
+    _pbCancelled = nullptr;
+
     /* Check the position chosen is valid, otherwise use the first valid one */
     uint8_t i = 0;
     while (i < grid.GetWidth() && !(grid.IsValidMove((uyBestMove + i) % grid.GetWidth()))) ++i;
     
-    if (i < grid.GetWidth()) grid.MakeMove(__ePlayerMark, (uyBestMove + i) % grid.GetWidth());
+    if (i == grid.GetWidth()) return TranspositionTable::SCuyNoMove;
+
+    grid.MakeMove(__ePlayerMark, (uyBestMove + i) % grid.GetWidth());
+    return (uyBestMove + i) % grid.GetWidth();
+}
+
+
+/**
+ * @brief Searches the grid left by the last move of the AI from the point of view of the opponent, until
+ * cancelled through its flag. The search fills the transposition table with the likely replies, so that the
+ * next move of the AI starts from them. Pondering runs on the calling thread alone
+ *
+ * @param Cgrid a copy of the main game board, the opponent being next to move
+ * @param CpbCancelled a flag whoever asked for the search may raise from any thread to stop it, if any
+ */
+void AI::Ponder(const Grid& Cgrid, const std::atomic<bool>* CpbCancelled) noexcept
+{
+    _bStopSearch.store(false, std::memory_order_relaxed);   // The last search may have run out of time
+
+    if (Cgrid.CheckWinner() == Grid::EPlayerMark::EMPTY && !Cgrid.IsFull())
+    {
+        SearchThread& searchThread = _vectorSearchThreads[0];
+
+        // The opponent's time has no limit, and entries are stored along with those of the last search
+        _timePointDeadline = std::chrono::steady_clock::time_point::max();
+        _pbCancelled = CpbCancelled;
+        searchThread.evaluator = Evaluator{Cgrid};
+        searchThread.moveOrdering.NewSearch();
+        searchThread.searchStats.NewSearch();
+
+        // One more iteration reaches the grids after every reply as deep as the next search will look at them
+        const uint8_t CuySearchLimit = (_uySearchLimit < std::numeric_limits<uint8_t>::max() ?
+            _uySearchLimit + 1 : _uySearchLimit);
+
+        WithBitboard(Cgrid, [this, &searchThread, CuySearchLimit](const auto& Cbitboard)
+            { return IterativeDeepening(Cbitboard, searchThread, NextPlayer(__ePlayerMark), 0, CuySearchLimit); });
+        _pbCancelled = nullptr;
+    }
 }
 
 
 /**
- * @brief Alpha-Beta Pruning algorithm
+ * @brief Lazy SMP search for the best move. Helper threads search the same position at the same time,
+ * filling the shared transposition table, while the calling thread finds the move that is played. Moves
+ * in the opening book are played without searching, and nearly full grids are solved exactly instead,
+ * unless they turn out to be lost
  * 
- * @param Cgrid the main game board
- * @param CePlayerMark the mark of this node's player
- * @param uyCurrentDepth the current depth of exploration
- * @param uyMaxDepth the maximum depth to explore
- * @param iAlpha alpha value for the AB-Pruning algorithm
- * @param iBeta beta value for the AB-Pruning algorithm
- * @param bIsMinNode signals if the current node is a Min node
- * @return int32_t the value of the current node
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param Cbitboard the main game board
+ * @return uint8_t the best column found
  */
-int32_t AI::AlphaBetaPruning(const Grid& Cgrid, const Grid::EPlayerMark& CePlayerMark, uint8_t uyCurrentDepth, 
-    uint8_t uyMaxDepth, int32_t iAlpha, int32_t iBeta, bool bIsMinNode) const noexcept
+template <typename TMask, typename TGeometry>
+uint8_t AI::SearchBestMove(const Bitboard<TMask, TGeometry>& Cbitboard) noexcept
 {
-    if (Cgrid.CheckWinner() != Grid::EPlayerMark::EMPTY)
+    if (_pOpeningBook != nullptr)
     {
-        if (Cgrid.CheckWinner() == __ePlayerMark) return std::numeric_limits<int32_t>::max();
-        else return std::numeric_limits<int32_t>::min();
+        const uint8_t CuyBookMove = _pOpeningBook->Probe(Cbitboard);
+        if (CuyBookMove != TranspositionTable::SCuyNoMove) return CuyBookMove;
     }
-    else if (Cgrid.IsFull()) return 0;
-    else if (uyCurrentDepth >= uyMaxDepth) return Heuristic(Cgrid);
-    else if (bIsMinNode)    // Min node
+
+    if (Cbitboard.GetEmptyCells() <= EndgameSolver::SCuyMaxEmptyCells)
     {
-        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta; ++i)
+        // A lost position is left to the search, whose evaluation tells which moves hold out longest, and so is
+        // a solve given up, out of time or cancelled, whose move was never compared with the others
+        Bitboard<TMask, TGeometry> bitboard{Cbitboard};
+        uint8_t uyBestMove = TranspositionTable::SCuyNoMove;
+        const int8_t CyValue = _endgameSolver.Solve(bitboard, __ePlayerMark, uyBestMove, (_uiThinkTime > 0 ?
+            _timePointDeadline : std::chrono::steady_clock::time_point::max()), _pbCancelled);
+        if (CyValue == EndgameSolver::SCyWin || CyValue == EndgameSolver::SCyDraw)
         {
-            if (Cgrid.IsValidMove(i))
-            {
-                Grid gridAttempt = Cgrid;
-                gridAttempt.MakeMove(CePlayerMark, i);
-                iBeta = std::min(iBeta, AlphaBetaPruning(gridAttempt, NextPlayer(CePlayerMark), 
-                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, false));
-            }
+            _vectorSearchThreads[0].uyDepthReached = Cbitboard.GetEmptyCells();   // Solved to the end
+            return uyBestMove;
         }
-        return iBeta;
     }
-    else                    // Max node
-    {
-        for (uint8_t i = 0; i < Cgrid.GetWidth() && iAlpha < iBeta; ++i)
+
+    _bStopSearch.store(false, std::memory_order_relaxed);
+
+    #ifndef __wii__
+        // Half of the helpers start one iteration ahead, so that threads spread over different depths
+        std::vector<std::thread> vectorThreads{};
+        vectorThreads.reserve(_vectorSearchThreads.size() - 1);
+
+        for (uint8_t i = 1; i < _vectorSearchThreads.size(); ++i)
         {
-            if (Cgrid.IsValidMove(i))
+            try
             {
-                Grid gridAttempt = Cgrid;
-                gridAttempt.MakeMove(CePlayerMark, i);
-                iAlpha = std::max(iAlpha, AlphaBetaPruning(gridAttempt, NextPlayer(CePlayerMark), 
-                    uyCurrentDepth + 1, uyMaxDepth, iAlpha, iBeta, true));
+                vectorThreads.emplace_back([this, &Cbitboard, i]()
+                    { IterativeDeepening(Cbitboard, _vectorSearchThreads[i], __ePlayerMark, i % 2, _uySearchLimit); });
             }
+            catch (const std::system_error& CsystemError) { break; }    // Go on with the threads already running
         }
-        return iAlpha;
-    }
+    #endif
+
+    uint8_t uyBestMove = IterativeDeepening(Cbitboard, _vectorSearchThreads[0], __ePlayerMark, 0, _uySearchLimit);
+
+    #ifndef __wii__
+        _bStopSearch.store(true, std::memory_order_relaxed);
+        for (std::thread& thread : vectorThreads) thread.join();
+    #endif
+
+    return uyBestMove;
 }
 
 
 /**
- * @brief Evaluation function
- *
- * @param Cgrid the main game board
- * @return int32_t a numeric evaluation of the board
+ * @brief Iterative deepening search for the best move. Every iteration but the first searches a narrow
+ * window around the score of the previous one, which is widened on the side the score falls out of until
+ * it falls inside. The search ends early once the position is found to be won or lost. If the search is
+ * stopped, the best move of the last completed iteration is returned
+ * 
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard a copy of the main game board, on which moves are made and undone
+ * @param searchThread the state of the thread running the search
+ * @param CePlayerMark the mark of the player to move on the board
+ * @param uyFirstIteration the first iteration to search, so that helpers can start deeper
+ * @param uySearchLimit the iteration to stop before
+ * @return uint8_t the best column found
  */
-int32_t AI::Heuristic(const Grid& Cgrid) const noexcept
+template <typename TMask, typename TGeometry>
+uint8_t AI::IterativeDeepening(Bitboard<TMask, TGeometry> bitboard, SearchThread& searchThread,
+    const Grid::EPlayerMark& CePlayerMark, uint8_t uyFirstIteration, uint8_t uySearchLimit) noexcept
 {
-    int32_t lHeuristic = 0;
-
-    Grid::EPlayerMark ePlayerMarkLast{};
-    uint8_t uySamePlayerMarkCount{}, uyEmptyCellCount{};
-    std::queue<Grid::EPlayerMark> quPlayerMarks{};
+    int32_t iScore = 0;
+    uint8_t uyBestMove = TranspositionTable::SCuyNoMove, uyCompletedBestMove = TranspositionTable::SCuyNoMove;
 
-    // Upwards check
-    if (Cgrid.GetHeight() >= Cgrid.GetCellsToWin())
+    for (uint8_t i = uyFirstIteration; i < uySearchLimit; ++i)   // Iterative deepening
     {
-        for (uint8_t i = 0; i < Cgrid.GetWidth(); ++i)
+        int32_t iDelta = SCiAspirationWindow;
+        int32_t iAlpha = -SCiWinScore, iBeta = SCiWinScore;
+
+        if (uyCompletedBestMove != TranspositionTable::SCuyNoMove)
         {
-            if (Cgrid.GetNextCell(i) < Cgrid.GetHeight() - 1)
-            {
-                ePlayerMarkLast = Cgrid[Cgrid.GetHeight() - 1][i];
-                uySamePlayerMarkCount = 1;
-                uyEmptyCellCount = 0;
-                quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-                quPlayerMarks.push(ePlayerMarkLast);
-
-                for (int8_t j = Cgrid.GetHeight() - 2;
-                    j >= std::max(0, Cgrid.GetNextCell(i) - Cgrid.GetCellsToWin() + 2); --j)
-                    lHeuristic += EvaluateSector(Cgrid, j, i, quPlayerMarks, ePlayerMarkLast,
-                        uySamePlayerMarkCount, uyEmptyCellCount);
-            }
+            iAlpha = (iScore > -SCiWinScore + iDelta ? iScore - iDelta : -SCiWinScore);
+            iBeta = (iScore < SCiWinScore - iDelta ? iScore + iDelta : SCiWinScore);
         }
-    }
 
-    // Horizontal check
-    int8_t yMaxColumnHeight = Cgrid.GetNextCell(0);
-    for (uint8_t i = 1; i < Cgrid.GetWidth(); ++i)
-        if (Cgrid.GetNextCell(i) < yMaxColumnHeight) yMaxColumnHeight = Cgrid.GetNextCell(i);
-    ++yMaxColumnHeight;
-
-    if (Cgrid.GetWidth() >= Cgrid.GetCellsToWin())
-    {
-        for (uint8_t i = yMaxColumnHeight; i < Cgrid.GetHeight(); ++i)
+        searchThread.searchStats.NewIteration(i + 1);
+        while (true)
         {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < Cgrid.GetWidth(); ++j)
-                lHeuristic += EvaluateSector(Cgrid, i, j, quPlayerMarks, ePlayerMarkLast,
-                    uySamePlayerMarkCount, uyEmptyCellCount);
+            iScore = SearchRoot(bitboard, searchThread, CePlayerMark, i, iAlpha, iBeta, uyBestMove);
+
+            // The moves of an unfinished iteration were not compared on equal terms
+            if (_bStopSearch.load(std::memory_order_relaxed))
+                return (uyCompletedBestMove != TranspositionTable::SCuyNoMove ? uyCompletedBestMove : uyBestMove);
+
+            if (iScore <= iAlpha && iAlpha > -SCiWinScore)
+                iAlpha = (iScore > -SCiWinScore + iDelta ? iScore - iDelta : -SCiWinScore);
+            else if (iScore >= iBeta && iBeta < SCiWinScore)
+                iBeta = (iScore < SCiWinScore - iDelta ? iScore + iDelta : SCiWinScore);
+            else break;
+
+            if (iDelta < SCiWinScore / 4) iDelta *= 4;
         }
+
+        uyCompletedBestMove = uyBestMove;
+        searchThread.uyDepthReached = i + 1;
+        searchThread.searchStats.EndIteration();
+        if (iScore >= SCiMinWinScore || iScore <= -SCiMinWinScore) break;   // Deeper searches find the same
     }
 
-    if (Cgrid.GetHeight() >= Cgrid.GetCellsToWin() && Cgrid.GetWidth() >= Cgrid.GetCellsToWin())
+    return uyBestMove;
+}
+
+
+/**
+ * @brief Searches every move of the root of the board within a window
+ *
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board being searched, which is left as it was found
+ * @param searchThread the state of the thread running the search
+ * @param CePlayerMark the mark of the player to move on the board
+ * @param uyDepthLeft the remaining depth to explore after the root moves
+ * @param iAlpha the lowest value of the window
+ * @param iBeta the highest value of the window
+ * @param uyBestMove the best column of the previous iteration, searched first, which is replaced by a
+ * better one if any is found
+ * @return int32_t the value of the root, which is only a bound if it falls outside the window
+ */
+template <typename TMask, typename TGeometry>
+int32_t AI::SearchRoot(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+    const Grid::EPlayerMark& CePlayerMark, uint8_t uyDepthLeft, int32_t iAlpha, int32_t iBeta,
+    uint8_t& uyBestMove) noexcept
+{
+    std::array<uint8_t, Grid::SCuyMaxWidth> auyMoves{};
+    int32_t iBestValue = -SCiWinScore;
+
+    // The best move of the previous iteration goes first, and stays the best one if every move fails low
+    uint8_t uyMoveCount = searchThread.moveOrdering.GetMoves(bitboard, CePlayerMark, uyBestMove, 0, auyMoves);
+    uyBestMove = auyMoves[0];
+
+    for (uint8_t i = 0; i < uyMoveCount; ++i)
     {
-        // Diagonal up right check
-        for (uint8_t i = std::max(static_cast<int8_t>(Cgrid.GetCellsToWin() - 1), yMaxColumnHeight);
-            i < Cgrid.GetHeight(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(Cgrid.GetWidth(), static_cast<uint8_t>(i - std::max(0,
-                yMaxColumnHeight - Cgrid.GetCellsToWin()))); ++j)
-                lHeuristic += EvaluateSector(Cgrid, i - j, j, quPlayerMarks, ePlayerMarkLast,
-                    uySamePlayerMarkCount, uyEmptyCellCount);
-        }
+        int32_t iValue = 0;
 
-        for (uint8_t i = 1; i <= Cgrid.GetWidth() - Cgrid.GetCellsToWin(); ++i)
+        MakeMove(bitboard, searchThread, CePlayerMark, auyMoves[i]);
+        if (i == 0) iValue = -PrincipalVariationSearch(bitboard, searchThread, NextPlayer(CePlayerMark), 1,
+            uyDepthLeft, -iBeta, -iAlpha);
+        else
         {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0;
-                j < std::min(static_cast<uint8_t>(Cgrid.GetWidth() - i), std::min(Cgrid.GetHeight(),
-                    static_cast<uint8_t>(Cgrid.GetHeight() - yMaxColumnHeight + 
-                    Cgrid.GetCellsToWin() - 1))); ++j)
-                lHeuristic += EvaluateSector(Cgrid, Cgrid.GetHeight() - 1 - j, i + j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
+            iValue = -PrincipalVariationSearch(bitboard, searchThread, NextPlayer(CePlayerMark), 1, uyDepthLeft,
+                -iAlpha - 1, -iAlpha);
+            if (iValue > iAlpha && iValue < iBeta) iValue = -PrincipalVariationSearch(bitboard, searchThread,
+                NextPlayer(CePlayerMark), 1, uyDepthLeft, -iBeta, -iAlpha);
         }
+        UndoMove(bitboard, searchThread, auyMoves[i]);
 
-        // Diagonal up left check
-        for (uint8_t i = Cgrid.GetCellsToWin() - 1; i < Cgrid.GetWidth(); ++i)
-        {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(static_cast<uint8_t>(i + 1), std::min(Cgrid.GetHeight(),
-                    static_cast<uint8_t>(Cgrid.GetHeight() -
-                    yMaxColumnHeight + Cgrid.GetCellsToWin() - 1))); ++j)
-                lHeuristic += EvaluateSector(Cgrid, Cgrid.GetHeight() - 1 - j, i - j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
-        }
+        if (_bStopSearch.load(std::memory_order_relaxed)) break;
 
-        for (uint8_t i = Cgrid.GetHeight() - 2;
-            i >= std::max(static_cast<int8_t>(Cgrid.GetCellsToWin() - 1), yMaxColumnHeight); --i)
+        if (iValue > iBestValue) iBestValue = iValue;
+        if (iValue > iAlpha)
         {
-            ePlayerMarkLast = Grid::EPlayerMark::EMPTY;
-            uySamePlayerMarkCount = 0;
-            uyEmptyCellCount = 0;
-            quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-
-            for (uint8_t j = 0; j < std::min(i, Cgrid.GetWidth()); ++j)
-                lHeuristic += EvaluateSector(Cgrid, i - j, Cgrid.GetWidth() - 1 - j, quPlayerMarks,
-                    ePlayerMarkLast, uySamePlayerMarkCount, uyEmptyCellCount);
+            iAlpha = iValue;
+            uyBestMove = auyMoves[i];
         }
+
+        if (iAlpha >= iBeta) break;
     }
 
-    return lHeuristic;
+    return iBestValue;
 }
 
 
 /**
- * @brief Helper function for the heuristic function. Used to build and keep track of free sectors, 
- * where there is only one type of player marker and where such player still has the chance to win
+ * @brief Negamax search with principal variation search. The first move of a node is searched with the full
+ * window and the rest with a null window, being searched again only if they turn out to be better. Threats
+ * are looked at first: a playable one wins at once, a playable one of the opponent is the only move to
+ * search, and no move is searched that lets the opponent play a threat on top of it
  * 
- * @param Cgrid the main game board
- * @param uyRow the row of the next cell to be added to the sector
- * @param uyColumn the column of the next cell to be added to the sector
- * @param quPlayerMarks the queue of cells that form the sector
- * @param ePlayerMarkLast the type of the last  non-empty cell that was found
- * @param uySamePlayerMarkCount the number of player marks of the same type that have been found in the
- *  current sector
- * @param uyEmptyCellCount the number of empty cells that have been found since the last non-empty cell
- * @return int32_t the heuristic evaluation for the current sector
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board being searched, which is left as it was found
+ * @param searchThread the state of the thread running the search
+ * @param CePlayerMark the mark of this node's player
+ * @param uyPly the distance of the node from the root
+ * @param uyDepthLeft the remaining depth to explore
+ * @param iAlpha the lowest value this node's player is already assured of
+ * @param iBeta the highest value the other player allows this node to get
+ * @return int32_t the value of the current node for this node's player
  */
-int32_t AI::EvaluateSector(const Grid& Cgrid, uint8_t uyRow, uint8_t uyColumn,
-    std::queue<Grid::EPlayerMark>& quPlayerMarks, Grid::EPlayerMark& ePlayerMarkLast,
-    uint8_t& uySamePlayerMarkCount, uint8_t& uyEmptyCellCount) const noexcept
+template <typename TMask, typename TGeometry>
+int32_t AI::PrincipalVariationSearch(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+    const Grid::EPlayerMark& CePlayerMark, uint8_t uyPly, uint8_t uyDepthLeft, int32_t iAlpha,
+    int32_t iBeta) noexcept
 {
-    if (Cgrid[uyRow][uyColumn] != Grid::EPlayerMark::EMPTY &&
-        ePlayerMarkLast != Grid::EPlayerMark::EMPTY &&
-        Cgrid[uyRow][uyColumn] != ePlayerMarkLast)
+    searchThread.searchStats.AddNode();
+
+    // Every thread looks at the clock and the request now and then, and the first to find the time is up or the
+    // search cancelled stops them all
+    if (++searchThread.ulNodeCount % SCuiClockCheckNodes == 0 &&
+        ((_uiThinkTime > 0 && std::chrono::steady_clock::now() >= _timePointDeadline) ||
+        (_pbCancelled != nullptr && _pbCancelled->load(std::memory_order_relaxed))))
+        _bStopSearch.store(true, std::memory_order_relaxed);
+
+    if (bitboard.CheckWinner() != Grid::EPlayerMark::EMPTY)
+        return (bitboard.CheckWinner() == CePlayerMark ? SCiWinScore - uyPly : -(SCiWinScore - uyPly));
+    else if (bitboard.IsFull()) return 0;
+    else if (uyDepthLeft == 0)
     {
-        quPlayerMarks = std::queue<Grid::EPlayerMark>{};
-        ePlayerMarkLast = Cgrid[uyRow][uyColumn];
-        uySamePlayerMarkCount = 1;
+        searchThread.searchStats.AddEvaluation();
+        return searchThread.evaluator.GetScore(CePlayerMark);
+    }
 
-        for (uint8_t i = 0; i < uyEmptyCellCount; ++i)
-            quPlayerMarks.push(Grid::EPlayerMark::EMPTY);
+    // A threat that can be played wins at once, and two of the opponent can no longer both be blocked
+    const Grid::EPlayerMark CeOpponent = NextPlayer(CePlayerMark);
+    uint8_t uyForcedBlock = TranspositionTable::SCuyNoMove, uyForcedBlockCount = 0;
+    uint16_t urUnsafeColumns = 0;   // Columns whose next cell lies right under a threat of the opponent
 
-        quPlayerMarks.push(ePlayerMarkLast);
-        uyEmptyCellCount = 0;
+    for (uint8_t i = 0; i < bitboard.GetWidth(); ++i)
+    {
+        const int8_t CyRow = bitboard.GetNextCell(i);
+        if (CyRow < 0) continue;
+
+        if (searchThread.evaluator.IsThreat(CePlayerMark, i, CyRow)) return SCiWinScore - (uyPly + 1);
+        else if (searchThread.evaluator.IsThreat(CeOpponent, i, CyRow))
+        {
+            uyForcedBlock = i;
+            ++uyForcedBlockCount;
+        }
+        if (CyRow > 0 && searchThread.evaluator.IsThreat(CeOpponent, i, CyRow - 1)) urUnsafeColumns |= 1 << i;
     }
-    else
+
+    if (uyForcedBlockCount > 1) return -(SCiWinScore - (uyPly + 2));
+
+    uint8_t uyHashMove = TranspositionTable::SCuyNoMove;
+    TranspositionTable::Entry entry{};
+
+    // Reuse the result of a previous search of this position or its mirror image, or at least its best move
+    const bool CbTableHit = _transpositionTable.Probe(bitboard.GetKey(), entry);
+    searchThread.searchStats.AddTableProbe(CbTableHit);
+
+    if (CbTableHit)
     {
-        quPlayerMarks.push(Cgrid[uyRow][uyColumn]);
+        uyHashMove = bitboard.GetCanonicalMove(entry.uyMove);
 
-        if (Cgrid[uyRow][uyColumn] == Grid::EPlayerMark::EMPTY) ++uyEmptyCellCount;
-        else
+        if (entry.uyDepth >= uyDepthLeft)
         {
-            uyEmptyCellCount = 0;
-            ++uySamePlayerMarkCount;
-            if (ePlayerMarkLast == Grid::EPlayerMark::EMPTY)
-                ePlayerMarkLast = Cgrid[uyRow][uyColumn];
+            const int32_t CiScore = FromTableScore(entry.iScore, uyPly);
+
+            if (entry.uyBound == TranspositionTable::EBound::EXACT) return CiScore;
+            else if (entry.uyBound == TranspositionTable::EBound::LOWER) iAlpha = std::max(iAlpha, CiScore);
+            else iBeta = std::min(iBeta, CiScore);
+
+            if (iAlpha >= iBeta) return CiScore;
         }
     }
 
-    if (quPlayerMarks.size() - 1 > Cgrid.GetCellsToWin())
+    const int32_t CiAlphaStart = iAlpha;
+    int32_t iBestValue = -SCiWinScore;
+    uint8_t uyBestMove = TranspositionTable::SCuyNoMove;
+
+    std::array<uint8_t, Grid::SCuyMaxWidth> auyMoves{};
+    uint8_t uyMoveCount = searchThread.moveOrdering.GetMoves(bitboard, CePlayerMark, uyHashMove, uyPly,
+        auyMoves);
+
+    // Only the block is worth searching when there is one, and otherwise no marker is played right under a
+    // threat of the opponent, which would let it be played next
+    uint8_t uyKeptCount = 0;
+
+    for (uint8_t i = 0; i < uyMoveCount; ++i)
     {
-        if (quPlayerMarks.front() == ePlayerMarkLast &&
-            ePlayerMarkLast != Grid::EPlayerMark::EMPTY) --uySamePlayerMarkCount;
-        quPlayerMarks.pop();
+        if (uyForcedBlock != TranspositionTable::SCuyNoMove ? auyMoves[i] == uyForcedBlock :
+            !(urUnsafeColumns & (1 << auyMoves[i]))) auyMoves[uyKeptCount++] = auyMoves[i];
     }
 
-    if (quPlayerMarks.size() >= Cgrid.GetCellsToWin())
+    if (uyKeptCount == 0) return -(SCiWinScore - (uyPly + 2));  // Every move hands a win to the opponent
+    uyMoveCount = uyKeptCount;
+
+    for (uint8_t i = 0; i < uyMoveCount; ++i)
     {
-        if (uySamePlayerMarkCount >= Cgrid.GetCellsToWin() || 
-            (uySamePlayerMarkCount == Cgrid.GetCellsToWin() - 1 && 
-            quPlayerMarks.front() == Grid::EPlayerMark::EMPTY && 
-            quPlayerMarks.back() == Grid::EPlayerMark::EMPTY)) 
-            return 1000000 * PlayerMark2Heuristic(ePlayerMarkLast);
-        else return std::pow(uySamePlayerMarkCount, uySamePlayerMarkCount) * 
-            PlayerMark2Heuristic(ePlayerMarkLast);
+        const uint8_t CuyColumn = auyMoves[i];
+        int32_t iValue = 0;
+
+        MakeMove(bitboard, searchThread, CePlayerMark, CuyColumn);
+        if (i == 0) iValue = -PrincipalVariationSearch(bitboard, searchThread, NextPlayer(CePlayerMark),
+            uyPly + 1, uyDepthLeft - 1, -iBeta, -iAlpha);
+        else
+        {
+            // Prove the move is not better with a null window, and search it properly only if it is
+            iValue = -PrincipalVariationSearch(bitboard, searchThread, NextPlayer(CePlayerMark), uyPly + 1,
+                uyDepthLeft - 1, -iAlpha - 1, -iAlpha);
+            if (iValue > iAlpha && iValue < iBeta) iValue = -PrincipalVariationSearch(bitboard, searchThread,
+                NextPlayer(CePlayerMark), uyPly + 1, uyDepthLeft - 1, -iBeta, -iAlpha);
+        }
+        UndoMove(bitboard, searchThread, CuyColumn);
+
+        if (_bStopSearch.load(std::memory_order_relaxed)) return 0;   // Unfinished results are not stored
+
+        if (iValue > iBestValue)
+        {
+            iBestValue = iValue;
+            uyBestMove = CuyColumn;
+        }
+        if (iValue > iAlpha) iAlpha = iValue;
+
+        if (iAlpha >= iBeta)
+        {
+            searchThread.searchStats.AddCutoff(i == 0);
+            searchThread.moveOrdering.AddCutoff(CePlayerMark, CuyColumn, bitboard.GetNextCell(CuyColumn), uyPly,
+                uyDepthLeft);
+            break;
+        }
+    }
+
+    // No move is known to be best when all of them failed low
+    TranspositionTable::EBound eBound = TranspositionTable::EBound::EXACT;
+    if (iBestValue <= CiAlphaStart)
+    {
+        eBound = TranspositionTable::EBound::UPPER;
+        uyBestMove = TranspositionTable::SCuyNoMove;
     }
+    else if (iBestValue >= iBeta) eBound = TranspositionTable::EBound::LOWER;
+
+    _transpositionTable.Store(bitboard.GetKey(), uyDepthLeft, eBound, ToTableScore(iBestValue, uyPly),
+        bitboard.GetCanonicalMove(uyBestMove));
 
-    return 0;
+    return iBestValue;
 }
 
 
 /**
- * @brief Gets the mark of the next player
+ * @brief Makes a move on the board of a search thread, keeping its evaluation up to date
  *
- * @param CePlayerMark the mark of the current player
- * @return EPlayerMark the mark of the next player
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board of the thread
+ * @param searchThread the state of the thread
+ * @param CePlayerMark the mark of the player that makes the move
+ * @param uyColumn the column of the move
  */
-Grid::EPlayerMark AI::NextPlayer(const Grid::EPlayerMark& CePlayerMark) const noexcept
+template <typename TMask, typename TGeometry>
+void AI::MakeMove(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread,
+    const Grid::EPlayerMark& CePlayerMark, uint8_t uyColumn) const noexcept
 {
-    if (CePlayerMark != __ePlayerMark) return __ePlayerMark;
-    else if (CePlayerMark == Grid::EPlayerMark::EMPTY) return Grid::EPlayerMark::EMPTY;
-    else return Grid::EPlayerMark::PLAYER1;
+    searchThread.evaluator.MakeMove(CePlayerMark, uyColumn, bitboard.GetNextCell(uyColumn));
+    bitboard.MakeMove(CePlayerMark, uyColumn);
 }
 
 
 /**
- * @brief Converts a player mark into a value for the evaluation function
+ * @brief Takes back the last move made in a column of the board of a search thread, keeping its evaluation
+ * up to date
  *
- * @param CePlayerMark the player mark to convert
- * @return int8_t a numeric representation of the player mark for the evaluation function
+ * @tparam TMask the bitmask type of the board
+ * @tparam TGeometry the size of the board if known at compile time
+ * @param bitboard the board of the thread
+ * @param searchThread the state of the thread
+ * @param uyColumn the column of the move
  */
-int8_t AI::PlayerMark2Heuristic(const Grid::EPlayerMark& CePlayerMark) const noexcept
+template <typename TMask, typename TGeometry>
+void AI::UndoMove(Bitboard<TMask, TGeometry>& bitboard, SearchThread& searchThread, uint8_t uyColumn) const noexcept
 {
-    if (CePlayerMark == __ePlayerMark) return 1;
-    else if (CePlayerMark == Grid::EPlayerMark::EMPTY) return 0;
-    else return -1;
+    const uint8_t CuyRow = bitboard.GetNextCell(uyColumn) + 1;
+
+    searchThread.evaluator.UndoMove(bitboard.GetCell(CuyRow, uyColumn), uyColumn, CuyRow);
+    bitboard.UndoMove(uyColumn);
 }
 
 
 /**
- * @brief Callback for running the AI algorithm in a separate thread
+ * @brief Gets the mark of the next player
  *
- * @param pData unused
- * @return int32_t error code of the thread
+ * @param CePlayerMark the mark of the current player
+ * @return EPlayerMark the mark of the next player
  */
-int32_t SDLCALL RunAI(void* pData)
+Grid::EPlayerMark AI::NextPlayer(const Grid::EPlayerMark& CePlayerMark) const noexcept
 {
-    App& app = App::GetInstance();
-
-    while (!(app._bStopThreads))  // Thread termination
-    {
-        while(SDL_SemWait(app._pSdlSemaphoreAI) == -1); // Wait until AI's turn
-
-        if (!(app._bStopThreads))
-        {
-            if (AI* pAI = dynamic_cast<AI*>(app._vectorpPlayers[app._uyCurrentPlayer]))
-            {
-                pAI->ChooseMove(app._grid);
-
-                // If the game is won or there is a draw go to the corresponding state
-                if (app._grid.CheckWinner() != Grid::EPlayerMark::EMPTY || app._grid.IsFull())
-                    app._eStateCurrent = App::EState::STATE_END;
-                else
-                {
-                    ++(app._uyCurrentPlayer) %= app._vectorpPlayers.size(); // Move turn
-
-                    // Check if next player is another AI
-                    if (typeid(*(app._vectorpPlayers[app._uyCurrentPlayer])) == typeid(AI))
-                        while (SDL_SemPost(app._pSdlSemaphoreAI) == -1);
-                }
-            }
-        }
-    }
-
-    return 0;
+    if (CePlayerMark == Grid::EPlayerMark::PLAYER1) return Grid::EPlayerMark::PLAYER2;
+    else if (CePlayerMark == Grid::EPlayerMark::PLAYER2) return Grid::EPlayerMark::PLAYER1;
+    else return Grid::EPlayerMark::EMPTY;
 }
@@ -0,0 +1,249 @@
+/*
+AIThread.cpp --- Background thread for the ConnectX AI players
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#ifdef SEARCH_STATS
+    #include <iostream>
+#endif
+
+#include <SDL.h>
+#include <SDL_events.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+#include "../../include/players/AIThread.hpp"
+#include "../../include/players/AI.hpp"
+#include "../../include/Grid.hpp"
+#include "../../include/ai/TranspositionTable.hpp"
+
+
+/**
+ * @brief Construct a new move request
+ *
+ * @param uiId the number that tells the request apart from the others
+ * @param ai the player that must move, which must outlive the search of the request
+ * @param Cgrid the main game board, which is copied
+ * @param bPonder whether the AI searches on the opponent's time once the move has been found
+ */
+AIThread::MoveRequest::MoveRequest(uint32_t uiId, AI& ai, const Grid& Cgrid, bool bPonder) : _uiId{uiId},
+    _pAI{&ai}, _grid{Cgrid}, _bPonder{bPonder}, _uyMove{TranspositionTable::SCuyNoMove}, _bReady{false},
+    _bCancelled{false} {}
+
+
+/**
+ * @brief Gives up the search of the move, or the pondering that follows it. The AI thread notices it
+ * within a few nodes, and no event is posted for a move that has not been posted yet. It can be called
+ * from any thread
+ */
+void AIThread::MoveRequest::Cancel() noexcept { _bCancelled.store(true, std::memory_order_relaxed); }
+
+
+/**
+ * @brief Construct a new AI thread, which waits for requests
+ */
+AIThread::AIThread() : _pSdlThread{nullptr}, _pSdlMutex{nullptr}, _pSdlSemaphore{nullptr}, _dequeJobs{},
+    _pMoveRequestRunning{nullptr}, _uiNextId{0}
+{
+    if ((_pSdlMutex = SDL_CreateMutex()) == nullptr) throw std::runtime_error(SDL_GetError());
+    if ((_pSdlSemaphore = SDL_CreateSemaphore(0)) == nullptr)
+    {
+        SDL_DestroyMutex(_pSdlMutex);
+        throw std::runtime_error(SDL_GetError());
+    }
+    if ((_pSdlThread = SDL_CreateThread(Run, this)) == nullptr)
+    {
+        SDL_DestroySemaphore(_pSdlSemaphore);
+        SDL_DestroyMutex(_pSdlMutex);
+        throw std::runtime_error(SDL_GetError());
+    }
+}
+
+
+/**
+ * @brief Destructor
+ */
+AIThread::~AIThread() noexcept
+{
+    Stop();
+
+    SDL_DestroySemaphore(_pSdlSemaphore);
+    _pSdlSemaphore = nullptr;
+    SDL_DestroyMutex(_pSdlMutex);
+    _pSdlMutex = nullptr;
+}
+
+
+/**
+ * @brief Asks an AI player for its move, which is searched after the requests made before
+ *
+ * @param ai the player that must move, which must outlive the search of the request
+ * @param Cgrid the main game board, which is copied
+ * @param bPonder whether the AI searches on the opponent's time once the move has been found
+ * @return std::shared_ptr<MoveRequest> the handle of the request, through which it can be cancelled
+ */
+std::shared_ptr<AIThread::MoveRequest> AIThread::RequestMove(AI& ai, const Grid& Cgrid, bool bPonder)
+{
+    std::shared_ptr<MoveRequest> pMoveRequest = std::make_shared<MoveRequest>(++_uiNextId, ai, Cgrid, bPonder);
+    PushJob(Job{pMoveRequest, nullptr});
+
+    return pMoveRequest;
+}
+
+
+/**
+ * @brief Cancels every request made so far and waits for the AI thread to be done with them, which takes
+ * no longer than the search of a few nodes. The players of the requests can be deleted afterwards
+ */
+void AIThread::CancelAll()
+{
+    SDL_sem* pSdlSemaphoreDone = SDL_CreateSemaphore(0);
+    if (pSdlSemaphoreDone == nullptr) throw std::runtime_error(SDL_GetError());
+
+    CancelRequests();
+
+    try { PushJob(Job{nullptr, pSdlSemaphoreDone}); }
+    catch (...)
+    {
+        SDL_DestroySemaphore(pSdlSemaphoreDone);
+        throw;
+    }
+
+    while (SDL_SemWait(pSdlSemaphoreDone) == -1);
+    SDL_DestroySemaphore(pSdlSemaphoreDone);
+}
+
+
+/**
+ * @brief Cancels every request made so far and waits for the AI thread to end. The destructor does it if
+ * it has not been done before
+ */
+void AIThread::Stop() noexcept
+{
+    if (_pSdlThread == nullptr) return;
+
+    CancelRequests();
+
+    try { PushJob(Job{nullptr, nullptr}); }
+    catch (...) { return; } // Without room for the last job the thread is left to the end of the program
+
+    SDL_WaitThread(_pSdlThread, nullptr);
+    _pSdlThread = nullptr;
+}
+
+
+/**
+ * @brief Cancels the request being searched and the ones waiting for it
+ */
+void AIThread::CancelRequests() noexcept
+{
+    while (SDL_LockMutex(_pSdlMutex) == -1);
+
+    if (_pMoveRequestRunning != nullptr) _pMoveRequestRunning->Cancel();
+    for (Job& job : _dequeJobs) if (job.pMoveRequest != nullptr) job.pMoveRequest->Cancel();
+
+    SDL_UnlockMutex(_pSdlMutex);
+}
+
+
+/**
+ * @brief Hands a job to the AI thread
+ *
+ * @param job the job to do after the ones given before
+ */
+void AIThread::PushJob(Job job)
+{
+    while (SDL_LockMutex(_pSdlMutex) == -1);
+    try { _dequeJobs.push_back(std::move(job)); }
+    catch (...)
+    {
+        SDL_UnlockMutex(_pSdlMutex);
+        throw;
+    }
+    SDL_UnlockMutex(_pSdlMutex);
+
+    while (SDL_SemPost(_pSdlSemaphore) == -1);
+}
+
+
+/**
+ * @brief Callback that runs the jobs of the AI thread until told to end
+ *
+ * @param pData the AI thread
+ * @return int32_t error code of the thread
+ */
+int32_t SDLCALL AIThread::Run(void* pData)
+{
+    AIThread& aiThread = *static_cast<AIThread*>(pData);
+
+    while (true)
+    {
+        while (SDL_SemWait(aiThread._pSdlSemaphore) == -1);    // Wait for a job
+
+        while (SDL_LockMutex(aiThread._pSdlMutex) == -1);
+        Job job = std::move(aiThread._dequeJobs.front());
+        aiThread._dequeJobs.pop_front();
+        aiThread._pMoveRequestRunning = job.pMoveRequest;
+        SDL_UnlockMutex(aiThread._pSdlMutex);
+
+        if (job.pMoveRequest != nullptr)
+        {
+            MoveRequest& moveRequest = *(job.pMoveRequest);
+
+            if (!(moveRequest.IsCancelled()))   // A request of a game already over is skipped
+            {
+                moveRequest._uyMove = moveRequest._pAI->ChooseMove(moveRequest._grid, &(moveRequest._bCancelled));
+                moveRequest._bReady.store(true, std::memory_order_release);
+
+                #ifdef SEARCH_STATS
+                    // The table of every move is written over the one before, where the console starts
+                    std::cout << "\x1b[2;0H";
+                    moveRequest._pAI->GetSearchStats().Print(std::cout);
+                #endif
+
+                if (!(moveRequest.IsCancelled()))
+                {
+                    SDL_Event sdlEvent{};
+                    sdlEvent.type = SDL_USEREVENT;
+                    sdlEvent.user.type = SDL_USEREVENT;
+                    sdlEvent.user.code = SCiMoveEventCode;
+                    sdlEvent.user.data1 = reinterpret_cast<void*>(static_cast<uintptr_t>(moveRequest._uiId));
+                    while (SDL_PushEvent(&sdlEvent) == -1);
+
+                    // The grid holds the move just made, so the opponent is next to move
+                    if (moveRequest._bPonder)
+                        moveRequest._pAI->Ponder(moveRequest._grid, &(moveRequest._bCancelled));
+                }
+            }
+
+            while (SDL_LockMutex(aiThread._pSdlMutex) == -1);
+            aiThread._pMoveRequestRunning = nullptr;
+            SDL_UnlockMutex(aiThread._pSdlMutex);
+        }
+        else if (job.pSdlSemaphoreDone != nullptr) while (SDL_SemPost(job.pSdlSemaphoreDone) == -1);
+        else break;     // Told to end
+    }
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+bench.cpp --- Search benchmark for the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <array>
+#include "Grid.hpp"
+#include "players/AI.hpp"
+
+#ifdef SEARCH_STATS
+    #include <iostream>
+#endif
+
+
+/**
+ * @brief A position of the benchmark
+ */
+struct Position
+{
+    uint8_t uyWidth;        /**< Width of the grid */
+    uint8_t uyHeight;       /**< Height of the grid */
+    uint8_t uyCellsToWin;   /**< Number of markers in a row that must be achieved */
+    const char* CsMoves;    /**< Columns played from the empty grid, one base-36 digit each */
+};
+
+
+/** Fixed set of undecided positions, the first player moving first */
+static const std::array<Position, 20> SCaPositions{{
+    {7, 6, 4, "243165460122512"},
+    {7, 6, 4, "405033121312002"},
+    {7, 6, 4, "125614"},
+    {7, 6, 4, "50"},
+    {7, 6, 4, "3130441144"},
+    {7, 6, 4, "646522522"},
+    {8, 7, 4, "1506343375"},
+    {8, 7, 4, "4064"},
+    {8, 7, 4, "665657140"},
+    {8, 7, 4, "2557212204426764041"},
+    {9, 7, 5, "5402370483310210034240"},
+    {9, 7, 5, "38064506260104836126"},
+    {9, 7, 5, "333373247620632"},
+    {10, 8, 5, "329214753826"},
+    {10, 8, 5, "9707"},
+    {10, 8, 5, "7159702503037968617543"},
+    {6, 5, 4, "1241051"},
+    {6, 5, 4, "53033"},
+    {16, 15, 5, "29a28ab67"},
+    {16, 15, 5, "96fbc45ff8357f0ad0695fc0d9898adb08d76188f42ec8cdefb38d912b803e"}
+}};
+
+
+/**
+ * Totals of the alpha-beta minimax the negamax with principal variation search replaced, over the same set on
+ * one thread with no think time. The time was taken on the machine of the recording and is only a rough guide
+ */
+static const uint8_t SCuyBaselineDepth = 9;             /**< Depth the baseline was recorded at */
+static const uint8_t SCuyBaselineTableSize = 4;         /**< Table size in MiB the baseline was recorded with */
+static const uint64_t SCulBaselineNodes = 2182405;      /**< Nodes the baseline searched */
+static const double SCdBaselineMilliseconds = 6971;     /**< Milliseconds the baseline took */
+
+
+/**
+ * @brief Searches every position of the set with a fresh AI and prints the nodes, time and move of each one,
+ * followed by the recorded totals of the alpha-beta baseline when run the way it was recorded
+ *
+ * @param argc number of arguments
+ * @param argv the search depth, the transposition table size in MiB, the number of threads and the think time
+ *  in milliseconds, all optional
+ * @return int error code of the program
+ */
+int main(int argc, char** argv)
+{
+    const uint8_t CuyDepth = (argc > 1 ? std::atoi(argv[1]) : 8);
+    const uint8_t CuyTableSize = (argc > 2 ? std::atoi(argv[2]) : 4);
+    const uint8_t CuyThreadCount = (argc > 3 ? std::atoi(argv[3]) : 1);
+    const uint32_t CuiThinkTime = (argc > 4 ? std::atoi(argv[4]) : 0);
+    uint64_t ulTotalNodes = 0;
+    uint32_t uiTotalDepth = 0;
+    double dTotalMilliseconds = 0;
+    uint32_t uiMoveHash = 0;
+
+    std::printf("depth %u, table %u MiB, %u threads, think time %u ms\n", CuyDepth, CuyTableSize, CuyThreadCount,
+        CuiThinkTime);
+    std::printf("%-10s %12s %10s %6s %6s\n", "board", "nodes", "ms", "depth", "move");
+
+    for (const Position& Cposition : SCaPositions)
+    {
+        Grid grid{Cposition.uyWidth, Cposition.uyHeight, Cposition.uyCellsToWin};
+        Grid::EPlayerMark ePlayerMark = Grid::EPlayerMark::PLAYER1;
+
+        for (const char* pcMove = Cposition.CsMoves; *pcMove != '\0'; ++pcMove)
+        {
+            grid.MakeMove(ePlayerMark, *pcMove <= '9' ? *pcMove - '0' : *pcMove - 'a' + 10);
+            ePlayerMark = (ePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+                Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+        }
+
+        AI ai{ePlayerMark, CuyDepth, CuyTableSize, CuyThreadCount, CuiThinkTime};
+        Grid gridBefore = grid;
+
+        std::chrono::steady_clock::time_point timePointStart = std::chrono::steady_clock::now();
+        ai.ChooseMove(grid);
+        double dMilliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - timePointStart).count();
+
+        uint8_t uyMove = 0;
+        while (grid.GetNextCell(uyMove) == gridBefore.GetNextCell(uyMove)) ++uyMove;
+
+        std::printf("%2ux%-2u/%-3u %12llu %10.1f %6u %6u\n", Cposition.uyWidth, Cposition.uyHeight,
+            Cposition.uyCellsToWin, static_cast<unsigned long long>(ai.GetNodeCount()), dMilliseconds,
+            ai.GetDepthReached(), uyMove);
+
+        #ifdef SEARCH_STATS
+            ai.GetSearchStats().Print(std::cout);
+        #endif
+
+        ulTotalNodes += ai.GetNodeCount();
+        uiTotalDepth += ai.GetDepthReached();
+        dTotalMilliseconds += dMilliseconds;
+        uiMoveHash = uiMoveHash * 31 + uyMove;
+    }
+
+    std::printf("%-10s %12llu %10.1f %6s %6s\n", "total", static_cast<unsigned long long>(ulTotalNodes),
+        dTotalMilliseconds, "", "");
+    std::printf("%.0f nodes/s, average depth %.2f, %.1f ms/move, move hash %08x\n",
+        ulTotalNodes / (dTotalMilliseconds / 1000), static_cast<double>(uiTotalDepth) / SCaPositions.size(),
+        dTotalMilliseconds / SCaPositions.size(), uiMoveHash);
+
+    if (CuyDepth == SCuyBaselineDepth && CuyTableSize == SCuyBaselineTableSize && CuyThreadCount == 1 &&
+        CuiThinkTime == 0)
+        std::printf("alpha-beta baseline %llu nodes, %.1f ms, %.2fx the nodes of this tree\n",
+            static_cast<unsigned long long>(SCulBaselineNodes), SCdBaselineMilliseconds,
+            static_cast<double>(SCulBaselineNodes) / ulTotalNodes);
+
+    return 0;
+}
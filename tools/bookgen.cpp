@@ -0,0 +1,124 @@
+/*
+bookgen.cpp --- Opening book generator for the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <ios>
+#include "Grid.hpp"
+#include "players/AI.hpp"
+#include "ai/Bitboard.hpp"
+#include "ai/Bitmask.hpp"
+#include "ai/OpeningBook.hpp"
+
+
+/**
+ * @brief Adds to the book the best move of a position and of every position reachable from it
+ *
+ * @param grid the position, which is left as it was found
+ * @param ai the AI of the player to move, which searches the position
+ * @param otherAI the AI of the other player, which searches the positions that follow
+ * @param uyPlies the number of moves that may still be played from the position
+ * @param unorderedsetulKeys the keys of the positions already in the book
+ * @param book the book being made
+ */
+static void AddPositions(Grid& grid, AI& ai, AI& otherAI, uint8_t uyPlies,
+    std::unordered_set<uint64_t>& unorderedsetulKeys, OpeningBook& book)
+{
+    if (grid.CheckWinner() != Grid::EPlayerMark::EMPTY || grid.IsFull()) return;
+
+    // Transpositions and mirror images are reached by different move orders, but only searched once
+    const Bitboard<Bitmask<4> > Cbitboard{grid};
+    if (!unorderedsetulKeys.insert(Cbitboard.GetKey()).second) return;
+
+    Grid gridAfter = grid;
+    ai.ChooseMove(gridAfter);
+
+    uint8_t uyMove = 0;
+    while (gridAfter.GetNextCell(uyMove) == grid.GetNextCell(uyMove)) ++uyMove;
+    book.AddMove(Cbitboard.GetKey(), Cbitboard.GetCanonicalMove(uyMove));
+
+    if (uyPlies > 0)
+    {
+        for (uint8_t i = 0; i < grid.GetWidth(); ++i)
+        {
+            if (!grid.IsValidMove(i)) continue;
+
+            grid.MakeMove(ai.GetPlayerMark(), i);
+            AddPositions(grid, otherAI, ai, uyPlies - 1, unorderedsetulKeys, book);
+            grid.UndoMove(i);
+        }
+    }
+}
+
+
+/**
+ * @brief Searches every position of the first moves of a game and stores the best move of each one in a book
+ * file, to be placed next to the settings of the game
+ *
+ * @param argc number of arguments
+ * @param argv the width and height of the grid and the number of markers in a row needed to win, followed by
+ *  the number of moves from the empty grid, the search depth and the output file, all three optional
+ * @return int error code of the program
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::fprintf(stderr, "Usage: %s <width> <height> <cellsToWin> [plies] [depth] [output]\n", argv[0]);
+        return 1;
+    }
+
+    const uint8_t CuyWidth = std::atoi(argv[1]);
+    const uint8_t CuyHeight = std::atoi(argv[2]);
+    const uint8_t CuyCellsToWin = std::atoi(argv[3]);
+    const uint8_t CuyPlies = (argc > 4 ? std::atoi(argv[4]) : 3);
+    const uint8_t CuyDepth = (argc > 5 ? std::atoi(argv[5]) : 12);
+    const std::string CsFilePath = (argc > 6 ? argv[6] :
+        OpeningBook::GetFileName(CuyWidth, CuyHeight, CuyCellsToWin));
+
+    if (CuyWidth == 0 || CuyWidth > Grid::SCuyMaxWidth || CuyHeight == 0 || CuyHeight > Grid::SCuyMaxHeight ||
+        CuyCellsToWin == 0)
+    {
+        std::fprintf(stderr, "Error: Invalid grid size\n");
+        return 1;
+    }
+
+    Grid grid{CuyWidth, CuyHeight, CuyCellsToWin};
+    OpeningBook book{CuyWidth, CuyHeight, CuyCellsToWin};
+    std::unordered_set<uint64_t> unorderedsetulKeys{};
+
+    // One AI per player searches all of its positions, its table carrying over from one to the next
+    AI ai1{Grid::EPlayerMark::PLAYER1, CuyDepth, 64}, ai2{Grid::EPlayerMark::PLAYER2, CuyDepth, 64};
+
+    AddPositions(grid, ai1, ai2, CuyPlies, unorderedsetulKeys, book);
+
+    try { book.Save(CsFilePath); }
+    catch (const std::ios_base::failure& CiosBaseFailure)
+    {
+        std::fprintf(stderr, "Error: Could not write %s\n", CsFilePath.c_str());
+        return 1;
+    }
+
+    std::printf("%u positions written to %s\n", book.GetSize(), CsFilePath.c_str());
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+crosscheck.cpp --- Checks that the bitboards agree with the grid on every size of grid
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include "Grid.hpp"
+#include "ai/Bitboard.hpp"
+
+
+static const uint8_t SCuyGamesPerSize = 16;     /**< Number of random games played on every size of grid */
+
+
+/**
+ * @brief Plays random games on a grid and on a bitboard at once, checking after every move that both boards
+ * hold the same cells and agree on the winner and on whether the board is full
+ *
+ * @tparam TBitboard the bitboard type
+ * @param Cgrid the empty grid
+ * @param CbitboardEmpty the same grid as a bitboard
+ * @param uiState the state of the random generator, which is moved forward
+ * @return uint32_t the number of moves after which the boards disagreed
+ */
+template <typename TBitboard>
+static uint32_t CrossCheck(const Grid& Cgrid, const TBitboard& CbitboardEmpty, uint32_t& uiState)
+{
+    const uint8_t CuyWidth = Cgrid.GetWidth(), CuyHeight = Cgrid.GetHeight();
+    uint32_t uiErrors = 0;
+
+    for (uint8_t i = 0; i < SCuyGamesPerSize; ++i)
+    {
+        Grid grid{Cgrid};
+        TBitboard bitboard{CbitboardEmpty};
+        Grid::EPlayerMark ePlayerMark = Grid::EPlayerMark::PLAYER1;
+
+        while (grid.CheckWinner() == Grid::EPlayerMark::EMPTY && !grid.IsFull())
+        {
+            // The moves are random, from a linear congruential generator
+            uiState = uiState * 1664525 + 1013904223;
+            uint8_t uyColumn = (uiState >> 16) % CuyWidth;
+            while (!grid.IsValidMove(uyColumn)) uyColumn = (uyColumn + 1) % CuyWidth;
+
+            grid.MakeMove(ePlayerMark, uyColumn);
+            bitboard.MakeMove(ePlayerMark, uyColumn);
+            ePlayerMark = (ePlayerMark == Grid::EPlayerMark::PLAYER1 ? Grid::EPlayerMark::PLAYER2 :
+                Grid::EPlayerMark::PLAYER1);
+
+            bool bAgree = (grid.CheckWinner() == bitboard.CheckWinner() && grid.IsFull() == bitboard.IsFull());
+            for (uint8_t j = 0; j < CuyHeight && bAgree; ++j)
+                for (uint8_t k = 0; k < CuyWidth && bAgree; ++k)
+                    bAgree = (grid[j][k] == bitboard.GetCell(j, k));
+
+            if (!bAgree)
+            {
+                std::printf("%ux%u/%u: the boards disagree after column %u, with %u empty cells left\n",
+                    CuyWidth, CuyHeight, Cgrid.GetCellsToWin(), uyColumn, bitboard.GetEmptyCells());
+                ++uiErrors;
+                break;
+            }
+        }
+    }
+
+    return uiErrors;
+}
+
+
+/**
+ * @brief Plays random games on every size of grid the settings allow, on the bitboard the AI would pick for
+ * it and on the widest bitboard, and fails if any of them ever disagrees with the grid on the winner or on
+ * whether the board is full
+ *
+ * @return int 0 if the boards always agreed, 1 otherwise
+ */
+int main()
+{
+    uint32_t uiState = 12345;
+    uint32_t uiSizes = 0, uiErrors = 0;
+
+    for (uint8_t uyWidth = 1; uyWidth <= Grid::SCuyMaxWidth; ++uyWidth)
+    {
+        for (uint8_t uyHeight = 1; uyHeight <= Grid::SCuyMaxHeight; ++uyHeight)
+        {
+            for (uint8_t uyCellsToWin = 1; uyCellsToWin <= std::max(uyWidth, uyHeight); ++uyCellsToWin)
+            {
+                const Grid Cgrid{uyWidth, uyHeight, uyCellsToWin};
+
+                uiErrors += WithBitboard(Cgrid, [&Cgrid, &uiState](const auto& Cbitboard)
+                    { return CrossCheck(Cgrid, Cbitboard, uiState); });
+                uiErrors += CrossCheck(Cgrid, Bitboard<Bitmask<4> >(Cgrid), uiState);
+                ++uiSizes;
+            }
+        }
+    }
+
+    std::printf("%u sizes, %u games each on two bitboards, %u disagreements\n", uiSizes, SCuyGamesPerSize,
+        uiErrors);
+
+    return (uiErrors == 0 ? 0 : 1);
+}
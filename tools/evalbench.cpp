@@ -0,0 +1,158 @@
+/*
+evalbench.cpp --- Evaluation micro-benchmark for the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <array>
+#include "Grid.hpp"
+#include "ai/Evaluator.hpp"
+
+
+static uint64_t SulAllocations = 0;     /**< Heap allocations made so far */
+
+
+void* operator new(std::size_t size)
+{
+    ++SulAllocations;
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+
+/**
+ * @brief A board geometry of the benchmark
+ */
+struct Geometry
+{
+    uint8_t uyWidth;        /**< Width of the grid */
+    uint8_t uyHeight;       /**< Height of the grid */
+    uint8_t uyCellsToWin;   /**< Number of markers in a row that must be achieved */
+};
+
+
+/** Board geometries, from the default one to the largest */
+static const std::array<Geometry, 4> SCaGeometries{{{7, 6, 4}, {9, 7, 5}, {10, 8, 5}, {16, 15, 5}}};
+
+
+/**
+ * @brief Plays random moves on an evaluator, taking some of them back as the search does, and prints the time
+ * per evaluation, the time to score every window from scratch, with the vector kernel and one by one, and the
+ * heap allocations for every geometry. Both ways of scoring from scratch are then checked against each other
+ * on as many positions as were rescored
+ *
+ * @param argc number of arguments
+ * @param argv the number of evaluations per geometry, optional
+ * @return int 0 if no evaluation allocated memory and both ways of scoring agreed, 1 otherwise
+ */
+int main(int argc, char** argv)
+{
+    const uint32_t CuiEvaluations = (argc > 1 ? std::atoi(argv[1]) : 10000000);
+    uint64_t ulTotalAllocations = 0;
+    uint32_t uiMismatches = 0;
+    int64_t lChecksum = 0;
+
+    std::printf("%-10s %12s %10s %12s %12s %12s\n", "board", "evaluations", "ns/eval", "ns/rescore", "ns/scalar",
+        "allocations");
+
+    for (const Geometry& Cgeometry : SCaGeometries)
+    {
+        Grid grid{Cgeometry.uyWidth, Cgeometry.uyHeight, Cgeometry.uyCellsToWin};
+        Evaluator evaluator{grid};
+        std::array<uint8_t, Grid::SCuyMaxWidth> auyHeights{};
+        std::array<std::array<Grid::EPlayerMark, Grid::SCuyMaxHeight>, Grid::SCuyMaxWidth> aaePlayerMarks{};
+        uint32_t uiState = 12345;
+        Grid::EPlayerMark ePlayerMark = Grid::EPlayerMark::PLAYER1;
+
+        // Plays a random move, and takes back a move every now and then
+        auto PlayRandomMove = [&]()
+        {
+            uiState = uiState * 1664525 + 1013904223;   // Linear congruential generator
+            const uint8_t CuyColumn = (uiState >> 16) % Cgeometry.uyWidth;
+
+            // Keep the columns below three quarters full, so that random moves rarely run out
+            if (auyHeights[CuyColumn] < Cgeometry.uyHeight * 3 / 4)
+            {
+                aaePlayerMarks[CuyColumn][auyHeights[CuyColumn]] = ePlayerMark;
+                evaluator.MakeMove(ePlayerMark, CuyColumn, Cgeometry.uyHeight - 1 - auyHeights[CuyColumn]++);
+                ePlayerMark = (ePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+                    Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+            }
+
+            if ((uiState >> 8) % 8 == 0)
+            {
+                const uint8_t CuyUndoColumn = (uiState >> 20) % Cgeometry.uyWidth;
+                if (auyHeights[CuyUndoColumn] > 0)
+                {
+                    const uint8_t CuyHeight = --auyHeights[CuyUndoColumn];
+                    evaluator.UndoMove(aaePlayerMarks[CuyUndoColumn][CuyHeight], CuyUndoColumn,
+                        Cgeometry.uyHeight - 1 - CuyHeight);
+                }
+            }
+        };
+
+        const uint64_t CulAllocationsStart = SulAllocations;
+        std::chrono::steady_clock::time_point timePointStart = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < CuiEvaluations; ++i)
+        {
+            PlayRandomMove();
+            lChecksum += evaluator.GetScore(ePlayerMark);
+        }
+
+        double dNanoseconds = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - timePointStart).count();
+
+        // Scoring every window from scratch is much slower, so it is timed fewer times
+        const uint32_t CuiRescores = CuiEvaluations / 100;
+        timePointStart = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < CuiRescores; ++i) lChecksum += evaluator.ScoreWindows();
+        double dRescoreNanoseconds = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - timePointStart).count();
+
+        timePointStart = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < CuiRescores; ++i) lChecksum += evaluator.ScoreWindowsScalar();
+        double dScalarNanoseconds = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - timePointStart).count();
+
+        for (uint32_t i = 0; i < CuiRescores; ++i)
+        {
+            PlayRandomMove();
+            if (evaluator.ScoreWindows() != evaluator.ScoreWindowsScalar()) ++uiMismatches;
+        }
+
+        const uint64_t CulAllocations = SulAllocations - CulAllocationsStart;
+
+        std::printf("%2ux%-2u/%-3u %12u %10.2f %12.2f %12.2f %12llu\n", Cgeometry.uyWidth, Cgeometry.uyHeight,
+            Cgeometry.uyCellsToWin, CuiEvaluations, dNanoseconds / CuiEvaluations, dRescoreNanoseconds / CuiRescores,
+            dScalarNanoseconds / CuiRescores, static_cast<unsigned long long>(CulAllocations));
+        ulTotalAllocations += CulAllocations;
+    }
+
+    std::printf("checksum %lld, %s, %u mismatches between the vector and the scalar scores\n",
+        static_cast<long long>(lChecksum), ulTotalAllocations == 0 ? "no allocations" : "ALLOCATIONS FOUND",
+        uiMismatches);
+
+    return (ulTotalAllocations == 0 && uiMismatches == 0 ? 0 : 1);
+}
@@ -0,0 +1,173 @@
+/*
+perft.cpp --- Move generation benchmark for the ConnectX boards
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <array>
+#include "Grid.hpp"
+#include "ai/Bitboard.hpp"
+
+
+/**
+ * @brief A position of the benchmark
+ */
+struct Position
+{
+    uint8_t uyWidth;        /**< Width of the grid */
+    uint8_t uyHeight;       /**< Height of the grid */
+    uint8_t uyCellsToWin;   /**< Number of markers in a row that must be achieved */
+    const char* CsMoves;    /**< Columns played from the empty grid, one base-36 digit each */
+    uint8_t uyDepth;        /**< Number of moves to play from the position */
+    uint64_t ulCount;       /**< Number of move sequences of that many moves, no move following a win */
+};
+
+
+/**
+ * Fixed set of undecided positions with their known counts, the first player moving first. The last three hold
+ * lines one marker short of a win, so that the wide boards also count sequences cut short by a win
+ */
+static const std::array<Position, 13> SCaPositions{{
+    {7, 6, 4, "", 8, 5673234},
+    {7, 6, 4, "3332", 8, 5438042},
+    {4, 4, 3, "", 12, 1112934},
+    {6, 5, 4, "1241051", 9, 7207260},
+    {8, 7, 4, "4064", 7, 1814044},
+    {9, 7, 5, "", 6, 531441},
+    {10, 8, 5, "9707", 6, 1000000},
+    {16, 15, 5, "", 5, 1048576},
+    {5, 4, 3, "0011", 11, 774645},
+    {3, 8, 3, "", 10, 25608},
+    {9, 7, 5, "0011223", 7, 3627998},
+    {10, 8, 5, "970733445", 6, 964020},
+    {16, 15, 5, "778899a", 5, 824416}
+}};
+
+
+/**
+ * @brief Counts the sequences of moves that can be played on a board
+ *
+ * @tparam TBoard the board type, either a grid or a bitboard
+ * @param board the board, which is left as it was found
+ * @param CePlayerMark the mark of the player to move
+ * @param uyDepth the number of moves of every sequence
+ * @return uint64_t the number of sequences
+ */
+template <typename TBoard>
+static uint64_t Perft(TBoard& board, const Grid::EPlayerMark& CePlayerMark, uint8_t uyDepth)
+{
+    if (uyDepth == 0) return 1;
+
+    const Grid::EPlayerMark CeOpponent = (CePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+        Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+    uint64_t ulCount = 0;
+
+    for (uint8_t i = 0; i < board.GetWidth(); ++i)
+    {
+        if (!board.IsValidMove(i)) continue;
+
+        board.MakeMove(CePlayerMark, i);
+        ulCount += (board.CheckWinner() == Grid::EPlayerMark::EMPTY ? Perft(board, CeOpponent, uyDepth - 1) :
+            (uyDepth == 1 ? 1 : 0));
+        board.UndoMove(i);
+    }
+
+    return ulCount;
+}
+
+
+/**
+ * @brief Counts and times the sequences of moves of a board
+ *
+ * @tparam TBoard the board type, either a grid or a bitboard
+ * @param board the board, which is left as it was found
+ * @param CePlayerMark the mark of the player to move
+ * @param uyDepth the number of moves of every sequence
+ * @param dMilliseconds the time taken, which is added to
+ * @return uint64_t the number of sequences
+ */
+template <typename TBoard>
+static uint64_t TimePerft(TBoard& board, const Grid::EPlayerMark& CePlayerMark, uint8_t uyDepth,
+    double& dMilliseconds)
+{
+    std::chrono::steady_clock::time_point timePointStart = std::chrono::steady_clock::now();
+    const uint64_t CulCount = Perft(board, CePlayerMark, uyDepth);
+    dMilliseconds += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - timePointStart).count();
+
+    return CulCount;
+}
+
+
+/**
+ * @brief Counts the sequences of moves of every position of the set on a grid and on a bitboard, checks them
+ * against the known counts and prints the positions per second of both boards
+ *
+ * @return int 0 if every count was right, 1 otherwise
+ */
+int main()
+{
+    uint64_t ulTotalCount = 0;
+    double dGridMilliseconds = 0, dBitboardMilliseconds = 0;
+    uint8_t uyErrors = 0;
+
+    std::printf("%-10s %-16s %6s %12s %10s %10s %6s\n", "board", "moves", "depth", "count", "grid ms",
+        "bitbrd ms", "");
+
+    for (const Position& Cposition : SCaPositions)
+    {
+        Grid grid{Cposition.uyWidth, Cposition.uyHeight, Cposition.uyCellsToWin};
+        Grid::EPlayerMark ePlayerMark = Grid::EPlayerMark::PLAYER1;
+
+        for (const char* pcMove = Cposition.CsMoves; *pcMove != '\0'; ++pcMove)
+        {
+            grid.MakeMove(ePlayerMark, *pcMove <= '9' ? *pcMove - '0' : *pcMove - 'a' + 10);
+            ePlayerMark = (ePlayerMark == Grid::EPlayerMark::PLAYER1 ?
+                Grid::EPlayerMark::PLAYER2 : Grid::EPlayerMark::PLAYER1);
+        }
+
+        double dGridPositionMilliseconds = 0, dBitboardPositionMilliseconds = 0;
+        const uint64_t CulGridCount = TimePerft(grid, ePlayerMark, Cposition.uyDepth, dGridPositionMilliseconds);
+
+        // The bitboard is the one the search builds, made for the size of the grid when it is a common one
+        const uint64_t CulBitboardCount = WithBitboard(grid, [&](auto bitboard)
+            { return TimePerft(bitboard, ePlayerMark, Cposition.uyDepth, dBitboardPositionMilliseconds); });
+
+        const bool CbRight = (CulGridCount == Cposition.ulCount && CulBitboardCount == Cposition.ulCount);
+        if (!CbRight) ++uyErrors;
+
+        std::printf("%2ux%-2u/%-3u %-16s %6u %12llu %10.1f %10.1f %6s\n", Cposition.uyWidth, Cposition.uyHeight,
+            Cposition.uyCellsToWin, Cposition.CsMoves, Cposition.uyDepth,
+            static_cast<unsigned long long>(CulGridCount), dGridPositionMilliseconds,
+            dBitboardPositionMilliseconds, CbRight ? "ok" : "WRONG");
+        if (!CbRight) std::printf("%-10s expected %llu, bitboard counted %llu\n", "",
+            static_cast<unsigned long long>(Cposition.ulCount), static_cast<unsigned long long>(CulBitboardCount));
+
+        ulTotalCount += Cposition.ulCount;
+        dGridMilliseconds += dGridPositionMilliseconds;
+        dBitboardMilliseconds += dBitboardPositionMilliseconds;
+    }
+
+    std::printf("grid %.0f positions/s, bitboard %.0f positions/s, %s\n",
+        ulTotalCount / (dGridMilliseconds / 1000), ulTotalCount / (dBitboardMilliseconds / 1000),
+        uyErrors == 0 ? "all counts right" : "WRONG COUNTS");
+
+    return (uyErrors == 0 ? 0 : 1);
+}
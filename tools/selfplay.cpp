@@ -0,0 +1,115 @@
+/*
+selfplay.cpp --- Self-play benchmark for the ConnectX AI
+Copyright (C) 2023  Juan de la Cruz Caravaca Guerrero (Quadraxis_v2)
+juan.dlcruzcg@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published
+by the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include "Grid.hpp"
+#include "players/AI.hpp"
+
+
+/**
+ * @brief Plays games of the AI against itself and prints the result of every game, followed by the nodes per
+ * second, the average depth reached, the time per move and a hash of every move played. The first two moves
+ * of every game are drawn from a fixed sequence, so that games differ from each other but not between runs
+ *
+ * @param argc number of arguments
+ * @param argv the number of games, the search depth, the transposition table size in MiB, the number of
+ *  threads, the think time in milliseconds and the width, height and cells to win of the grid, all optional
+ * @return int error code of the program
+ */
+int main(int argc, char** argv)
+{
+    const uint32_t CuiGames = (argc > 1 ? std::atoi(argv[1]) : 10);
+    const uint8_t CuyDepth = (argc > 2 ? std::atoi(argv[2]) : 8);
+    const uint8_t CuyTableSize = (argc > 3 ? std::atoi(argv[3]) : 4);
+    const uint8_t CuyThreadCount = (argc > 4 ? std::atoi(argv[4]) : 1);
+    const uint32_t CuiThinkTime = (argc > 5 ? std::atoi(argv[5]) : 0);
+    const uint8_t CuyWidth = (argc > 6 ? std::atoi(argv[6]) : 7);
+    const uint8_t CuyHeight = (argc > 7 ? std::atoi(argv[7]) : 6);
+    const uint8_t CuyCellsToWin = (argc > 8 ? std::atoi(argv[8]) : 4);
+    uint64_t ulTotalNodes = 0;
+    uint32_t uiTotalDepth = 0, uiTotalMoves = 0;
+    double dTotalMilliseconds = 0;
+    uint32_t uiMoveHash = 0;
+    uint32_t uiState = 12345;
+
+    std::printf("%ux%u/%u, %u games, depth %u, table %u MiB, %u threads, think time %u ms\n", CuyWidth,
+        CuyHeight, CuyCellsToWin, CuiGames, CuyDepth, CuyTableSize, CuyThreadCount, CuiThinkTime);
+    std::printf("%-6s %6s %12s %10s %8s %8s\n", "game", "moves", "nodes", "ms", "depth", "winner");
+
+    for (uint32_t i = 0; i < CuiGames; ++i)
+    {
+        Grid grid{CuyWidth, CuyHeight, CuyCellsToWin};
+        AI aiPlayer1{Grid::EPlayerMark::PLAYER1, CuyDepth, CuyTableSize, CuyThreadCount, CuiThinkTime};
+        AI aiPlayer2{Grid::EPlayerMark::PLAYER2, CuyDepth, CuyTableSize, CuyThreadCount, CuiThinkTime};
+        AI* pAI = &aiPlayer1;
+        uint64_t ulGameNodes = 0;
+        uint32_t uiGameDepth = 0, uiGameMoves = 0;
+        double dGameMilliseconds = 0;
+
+        for (uint8_t j = 0; j < 2 && grid.CheckWinner() == Grid::EPlayerMark::EMPTY && !grid.IsFull(); ++j)
+        {
+            // The opening moves are random, from a linear congruential generator
+            uiState = uiState * 1664525 + 1013904223;
+            uint8_t uyColumn = (uiState >> 16) % CuyWidth;
+            while (!grid.IsValidMove(uyColumn)) uyColumn = (uyColumn + 1) % CuyWidth;
+
+            grid.MakeMove(pAI->GetPlayerMark(), uyColumn);
+            pAI = (pAI == &aiPlayer1 ? &aiPlayer2 : &aiPlayer1);
+        }
+
+        while (grid.CheckWinner() == Grid::EPlayerMark::EMPTY && !grid.IsFull())
+        {
+            Grid gridBefore = grid;
+
+            std::chrono::steady_clock::time_point timePointStart = std::chrono::steady_clock::now();
+            pAI->ChooseMove(grid);
+            dGameMilliseconds += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - timePointStart).count();
+
+            uint8_t uyMove = 0;
+            while (grid.GetNextCell(uyMove) == gridBefore.GetNextCell(uyMove)) ++uyMove;
+
+            ulGameNodes += pAI->GetNodeCount();
+            uiGameDepth += pAI->GetDepthReached();
+            ++uiGameMoves;
+            uiMoveHash = uiMoveHash * 31 + uyMove;
+            pAI = (pAI == &aiPlayer1 ? &aiPlayer2 : &aiPlayer1);
+        }
+
+        std::printf("%-6u %6u %12llu %10.1f %8.2f %8u\n", i + 1, uiGameMoves,
+            static_cast<unsigned long long>(ulGameNodes), dGameMilliseconds,
+            uiGameMoves > 0 ? static_cast<double>(uiGameDepth) / uiGameMoves : 0.0, grid.CheckWinner());
+
+        ulTotalNodes += ulGameNodes;
+        uiTotalDepth += uiGameDepth;
+        uiTotalMoves += uiGameMoves;
+        dTotalMilliseconds += dGameMilliseconds;
+    }
+
+    if (uiTotalMoves == 0) return 0;
+
+    std::printf("%.0f nodes/s, average depth %.2f, %.1f ms/move, move hash %08x\n",
+        ulTotalNodes / (dTotalMilliseconds / 1000), static_cast<double>(uiTotalDepth) / uiTotalMoves,
+        dTotalMilliseconds / uiTotalMoves, uiMoveHash);
+
+    return 0;
+}